@@ -0,0 +1,275 @@
+/**
+ * @file adc_stream.c
+ * @brief Implementação do serviço de aquisição contínua do ADC (round-robin + DMA)
+ */
+
+#include "adc_stream.h"
+#include "hardware/adc.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+
+// Buffers do ping-pong do DMA (um por canal de DMA).
+static adc_sample_t dma_buffers[2][ADC_STREAM_BLOCK];
+static uint dma_channels[2];
+
+// Buffers circulares por canal do ADC e ordem de conversão do round-robin.
+static adc_ring_t rings[ADC_STREAM_MAX_CHANNELS];
+static uint8_t order[ADC_STREAM_MAX_CHANNELS];
+static uint order_count;
+static uint order_slot; // Canal (posição em order) da próxima amostra recebida.
+static uint channel_mask;
+
+static float adc_clkdiv;
+static bool running;
+
+/**
+ * Grava uma amostra no buffer circular do canal, aplicando a dizimação.
+ */
+static inline void ring_push(adc_ring_t *ring, adc_sample_t sample) {
+    if (ring->decimation > 1) {
+        ring->acc += sample;
+        if (++ring->acc_count < ring->decimation)
+            return;
+        sample = ring->acc / ring->decimation;
+        ring->acc = 0;
+        ring->acc_count = 0;
+    }
+
+    ring->buffer[ring->head & ring->mask] = sample;
+    ring->head++;
+}
+
+/**
+ * Separa um bloco intercalado do round-robin nos buffers de cada canal.
+ * A posição no round-robin é mantida entre blocos, então o tamanho do bloco
+ * não precisa ser múltiplo do número de canais.
+ */
+static void demux_block(const adc_sample_t *block, uint count) {
+    uint slot = order_slot;
+
+    for (uint i = 0; i < count; ++i) {
+        ring_push(&rings[order[slot]], block[i]);
+        if (++slot == order_count)
+            slot = 0;
+    }
+
+    order_slot = slot;
+}
+
+/**
+ * Interrupção do DMA: um dos buffers do ping-pong terminou. O outro canal de
+ * DMA já assumiu a transferência (chain), então basta rearmar o endereço de
+ * escrita deste canal e distribuir suas amostras.
+ */
+static void adc_stream_dma_handler(void) {
+    for (uint i = 0; i < 2; ++i) {
+        uint ch = dma_channels[i];
+        if (!dma_channel_get_irq0_status(ch))
+            continue;
+
+        dma_channel_acknowledge_irq0(ch);
+        dma_channel_set_write_addr(ch, dma_buffers[i], false);
+        demux_block(dma_buffers[i], ADC_STREAM_BLOCK);
+    }
+}
+
+/**
+ * Configura um dos canais do ping-pong, encadeado ao outro ao terminar.
+ */
+static void configure_dma_channel(uint index) {
+    uint ch = dma_channels[index];
+    dma_channel_config cfg = dma_channel_get_default_config(ch);
+
+#if ADC_STREAM_8BIT
+    channel_config_set_transfer_data_size(&cfg, DMA_SIZE_8);  // 8 bits mais significativos
+#else
+    channel_config_set_transfer_data_size(&cfg, DMA_SIZE_16); // Amostras de 12-bits em 16-bits
+#endif
+    channel_config_set_read_increment(&cfg, false);            // Sempre lê do FIFO do ADC
+    channel_config_set_write_increment(&cfg, true);            // Avança no buffer
+    channel_config_set_dreq(&cfg, DREQ_ADC);                   // Ritmo ditado pelo ADC
+    channel_config_set_chain_to(&cfg, dma_channels[index ^ 1u]);
+
+    dma_channel_configure(ch, &cfg,
+        dma_buffers[index], // Escreve no buffer do ping-pong.
+        &adc_hw->fifo,      // Lê do ADC.
+        ADC_STREAM_BLOCK,
+        false               // Só inicia em adc_stream_start() ou pelo chain.
+    );
+
+    dma_channel_set_irq0_enabled(ch, true);
+}
+
+void adc_stream_init(float clkdiv) {
+    adc_init();
+    adc_clkdiv = clkdiv;
+    order_count = 0;
+    channel_mask = 0;
+    running = false;
+
+    dma_channels[0] = dma_claim_unused_channel(true);
+    dma_channels[1] = dma_claim_unused_channel(true);
+
+    irq_set_exclusive_handler(DMA_IRQ_0, adc_stream_dma_handler);
+    irq_set_enabled(DMA_IRQ_0, true);
+}
+
+bool adc_stream_add_channel(uint channel, adc_sample_t *buffer, uint size, uint decimation) {
+    if (running || channel >= ADC_STREAM_MAX_CHANNELS || (channel_mask & (1u << channel)))
+        return false;
+    if (buffer == NULL || size == 0 || (size & (size - 1)) != 0 || decimation == 0)
+        return false;
+
+    adc_ring_t *ring = &rings[channel];
+    ring->buffer = buffer;
+    ring->mask = size - 1;
+    ring->head = 0;
+    ring->tail = 0;
+    ring->decimation = decimation;
+    ring->acc = 0;
+    ring->acc_count = 0;
+    ring->overruns = 0;
+
+    if (channel == ADC_STREAM_TEMP_CHANNEL)
+        adc_set_temp_sensor_enabled(true);
+    else
+        adc_gpio_init(26 + channel);
+
+    channel_mask |= 1u << channel;
+    return true;
+}
+
+void adc_stream_start(void) {
+    if (running || channel_mask == 0)
+        return;
+
+    // O round-robin converte os canais da máscara em ordem crescente,
+    // começando pelo canal selecionado: começamos pelo menor.
+    order_count = 0;
+    for (uint ch = 0; ch < ADC_STREAM_MAX_CHANNELS; ++ch)
+        if (channel_mask & (1u << ch))
+            order[order_count++] = ch;
+    order_slot = 0;
+
+    adc_run(false);
+    adc_select_input(order[0]);
+    adc_set_round_robin(order_count > 1 ? channel_mask : 0);
+    adc_fifo_setup(
+        true,  // Habilitar FIFO
+        true,  // Habilitar request de dados do DMA
+        1,     // Threshold para ativar request DMA é 1 leitura do ADC
+        false, // Não usar bit de erro
+        ADC_STREAM_8BIT // Deslocar para 8-bits (ou manter os 12-bits)
+    );
+    adc_set_clkdiv(adc_clkdiv);
+    adc_fifo_drain();
+
+    configure_dma_channel(0);
+    configure_dma_channel(1);
+
+    running = true;
+    dma_channel_start(dma_channels[0]);
+    adc_run(true);
+}
+
+void adc_stream_stop(void) {
+    if (!running)
+        return;
+
+    adc_run(false);
+    running = false;
+
+    // Desabilita os dois canais antes de abortar, para que o fim de um
+    // não dispare o outro pelo chain.
+    for (uint i = 0; i < 2; ++i) {
+        dma_channel_set_irq0_enabled(dma_channels[i], false);
+        hw_clear_bits(&dma_hw->ch[dma_channels[i]].al1_ctrl, DMA_CH0_CTRL_TRIG_EN_BITS);
+    }
+    dma_hw->abort = (1u << dma_channels[0]) | (1u << dma_channels[1]);
+    while (dma_hw->abort)
+        tight_loop_contents();
+    for (uint i = 0; i < 2; ++i)
+        dma_channel_acknowledge_irq0(dma_channels[i]);
+
+    adc_fifo_drain();
+    adc_set_round_robin(0);
+}
+
+float adc_stream_rate(uint channel) {
+    if (channel >= ADC_STREAM_MAX_CHANNELS || !(channel_mask & (1u << channel)))
+        return 0.f;
+
+    uint count = 0;
+    for (uint ch = 0; ch < ADC_STREAM_MAX_CHANNELS; ++ch)
+        if (channel_mask & (1u << ch))
+            ++count;
+
+    // Com clkdiv menor que 96 o ADC converte sem pausa (96 ciclos por amostra).
+    float period = adc_clkdiv < 96.f ? 96.f : 1.f + adc_clkdiv;
+    return ADC_CLOCK_HZ / period / count / rings[channel].decimation;
+}
+
+/**
+ * Descarta amostras que já foram sobrescritas pela interrupção e devolve
+ * quantas amostras válidas existem para leitura.
+ */
+static uint32_t ring_sync(adc_ring_t *ring) {
+    uint32_t avail = ring->head - ring->tail;
+    uint32_t size = ring->mask + 1;
+
+    if (avail > size) {
+        ring->overruns += avail - size;
+        ring->tail = ring->head - size;
+        avail = size;
+    }
+    return avail;
+}
+
+uint adc_stream_available(uint channel) {
+    if (channel >= ADC_STREAM_MAX_CHANNELS || rings[channel].buffer == NULL)
+        return 0;
+    return ring_sync(&rings[channel]);
+}
+
+uint adc_stream_read(uint channel, adc_sample_t *dst, uint count) {
+    if (channel >= ADC_STREAM_MAX_CHANNELS || rings[channel].buffer == NULL)
+        return 0;
+
+    adc_ring_t *ring = &rings[channel];
+    uint32_t avail = ring_sync(ring);
+    if (count > avail)
+        count = avail;
+
+    for (uint i = 0; i < count; ++i)
+        dst[i] = ring->buffer[(ring->tail + i) & ring->mask];
+    ring->tail += count;
+
+    return count;
+}
+
+uint adc_stream_read_latest(uint channel, adc_sample_t *dst, uint count) {
+    if (channel >= ADC_STREAM_MAX_CHANNELS || rings[channel].buffer == NULL)
+        return 0;
+
+    adc_ring_t *ring = &rings[channel];
+    uint32_t avail = ring_sync(ring);
+    if (avail > count)
+        ring->tail += avail - count; // Descarta as amostras antigas.
+
+    return adc_stream_read(channel, dst, count);
+}
+
+uint16_t adc_stream_latest(uint channel) {
+    if (channel >= ADC_STREAM_MAX_CHANNELS || rings[channel].buffer == NULL)
+        return 0;
+
+    adc_ring_t *ring = &rings[channel];
+    uint32_t head = ring->head;
+    return head ? ring->buffer[(head - 1) & ring->mask] : 0;
+}
+
+uint32_t adc_stream_overruns(uint channel) {
+    if (channel >= ADC_STREAM_MAX_CHANNELS)
+        return 0;
+    return rings[channel].overruns;
+}
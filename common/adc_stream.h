@@ -0,0 +1,142 @@
+/**
+ * @file adc_stream.h
+ * @brief Serviço compartilhado de aquisição contínua do ADC (round-robin + DMA)
+ *
+ * Em vez de cada módulo chamar adc_select_input()/adc_read() de forma
+ * bloqueante, todos os canais habilitados são amostrados em um único fluxo:
+ * o ADC percorre a máscara de round-robin e o DMA grava as amostras em dois
+ * buffers alternados (ping-pong). A cada buffer completo, a interrupção do DMA
+ * separa as amostras em um buffer circular por canal, aplicando a dizimação
+ * (média de N amostras) configurada para aquele canal.
+ *
+ * Taxa de cada canal = (48 MHz / (1 + clkdiv)) / canais_ativos / dizimação
+ *
+ * Uma só cópia, em common/, usada por todos os projetos que leem o ADC: cada
+ * CMakeLists.txt inclui common/adc_stream.c e o diretório common/.
+ *
+ * Com ADC_STREAM_8BIT=1 o FIFO entrega só os 8 bits mais significativos e o
+ * DMA transfere bytes: a mesma memória guarda o dobro de áudio e o tráfego do
+ * DMA cai pela metade. Os módulos de DSP usam adc_sample_t e são compilados
+ * para a largura escolhida; limiares definidos em 12-bits passam por
+ * ADC_LEVEL()/ADC_ENERGY().
+ */
+
+#ifndef ADC_STREAM_H
+#define ADC_STREAM_H
+
+#include "pico/stdlib.h"
+#include <stdbool.h>
+
+#define ADC_STREAM_MAX_CHANNELS 5   // ADC0 a ADC3 (GPIO 26 a 29) e ADC4 (sensor de temperatura)
+#define ADC_STREAM_TEMP_CHANNEL 4
+#define ADC_CLOCK_HZ 48000000.f     // Clock do ADC (clk_adc)
+
+// Amostras por buffer de DMA (cada metade do ping-pong). Cada projeto escolhe
+// o seu no CMakeLists.txt: um bloco só chega aos buffers circulares quando
+// enche, então blocos grandes atrasam a leitura em ADC_STREAM_BLOCK amostras
+// do round-robin, e blocos pequenos geram mais interrupções.
+#ifndef ADC_STREAM_BLOCK
+#define ADC_STREAM_BLOCK 128
+#endif
+
+#ifndef ADC_STREAM_8BIT
+#define ADC_STREAM_8BIT 0           // 1: amostras de 8-bits (definido no CMakeLists.txt)
+#endif
+
+#if ADC_STREAM_8BIT
+typedef uint8_t adc_sample_t;
+#define ADC_SAMPLE_BITS 8
+#else
+typedef uint16_t adc_sample_t;
+#define ADC_SAMPLE_BITS 12
+#endif
+
+#define ADC_SAMPLE_SHIFT (12 - ADC_SAMPLE_BITS)         // Bits descartados em relação aos 12-bits
+#define ADC_SAMPLE_MID (2048u >> ADC_SAMPLE_SHIFT)      // Leitura de 1,65 V (offset do microfone)
+#define ADC_LEVEL(x) ((x) >> ADC_SAMPLE_SHIFT)          // Amplitude em contagens de 12-bits -> largura atual
+#define ADC_ENERGY(x) ((x) >> (2 * ADC_SAMPLE_SHIFT))   // Energia (contagens²) de 12-bits -> largura atual
+
+/**
+ * @brief Buffer circular de um canal do ADC
+ *
+ * Os índices são contadores livres (não dão a volta no tamanho do buffer):
+ * head é escrito apenas pela interrupção do DMA e tail apenas pelo leitor.
+ */
+typedef struct {
+    adc_sample_t *buffer;       /**< Memória do buffer (tamanho potência de 2) */
+    uint32_t mask;              /**< Tamanho do buffer - 1 */
+    volatile uint32_t head;     /**< Total de amostras já escritas */
+    uint32_t tail;              /**< Total de amostras já consumidas */
+    uint16_t decimation;        /**< Mantém 1 amostra (média) a cada N lidas */
+    uint16_t acc_count;         /**< Amostras acumuladas para a dizimação */
+    uint32_t acc;               /**< Soma das amostras acumuladas */
+    volatile uint32_t overruns; /**< Amostras perdidas por leitura atrasada */
+} adc_ring_t;
+
+/**
+ * @brief Prepara o ADC e os canais de DMA do serviço
+ *
+ * @param clkdiv Divisor do clock do ADC (intervalo entre conversões de 1 + clkdiv ciclos)
+ */
+void adc_stream_init(float clkdiv);
+
+/**
+ * @brief Inclui um canal no round-robin
+ *
+ * Deve ser chamada antes de adc_stream_start().
+ *
+ * @param channel Canal do ADC (0 a 4)
+ * @param buffer Memória do buffer circular do canal
+ * @param size Tamanho do buffer (potência de 2)
+ * @param decimation Fator de dizimação do canal (1 = todas as amostras)
+ * @return true se o canal foi configurado, false se os parâmetros forem inválidos
+ */
+bool adc_stream_add_channel(uint channel, adc_sample_t *buffer, uint size, uint decimation);
+
+/**
+ * @brief Inicia a aquisição contínua de todos os canais configurados
+ */
+void adc_stream_start(void);
+
+/**
+ * @brief Interrompe a aquisição (os dados já nos buffers são mantidos)
+ */
+void adc_stream_stop(void);
+
+/**
+ * @brief Taxa de amostragem efetiva de um canal, em Hz
+ */
+float adc_stream_rate(uint channel);
+
+/**
+ * @brief Número de amostras novas disponíveis em um canal
+ */
+uint adc_stream_available(uint channel);
+
+/**
+ * @brief Lê (e consome) até count amostras de um canal, da mais antiga para a mais nova
+ *
+ * @return Número de amostras copiadas para dst
+ */
+uint adc_stream_read(uint channel, adc_sample_t *dst, uint count);
+
+/**
+ * @brief Copia as count amostras mais recentes e descarta as anteriores
+ *
+ * Útil para quem só precisa da janela mais atual (medidores, joystick).
+ *
+ * @return Número de amostras copiadas para dst
+ */
+uint adc_stream_read_latest(uint channel, adc_sample_t *dst, uint count);
+
+/**
+ * @brief Última amostra de um canal, sem consumir o buffer
+ */
+uint16_t adc_stream_latest(uint channel);
+
+/**
+ * @brief Total de amostras perdidas em um canal por falta de leitura
+ */
+uint32_t adc_stream_overruns(uint channel);
+
+#endif /* ADC_STREAM_H */
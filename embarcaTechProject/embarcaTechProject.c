@@ -5,7 +5,7 @@
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
 #include "inc/ssd1306.h"
-#include "hardware/adc.h"
+#include "adc_stream.h" // aquisição contínua do ADC (round-robin + DMA)
 #include "hardware/pwm.h"
 #include "inc/ledsArray.h" // para utilização da matriz de LEDs
 
@@ -15,6 +15,11 @@
 #define I2C_SDA 14
 #define I2C_SCL 15
 
+#define TEMP_CLOCK_DIV 47999.f // 48 MHz / (1 + 47999) = 1 kHz de amostragem do sensor
+#define TEMP_RING_SIZE 256     // Buffer circular do sensor de temperatura (potência de 2)
+
+uint16_t temp_ring[TEMP_RING_SIZE];
+
 /* ========== FUNÇÕES AUXILIARES ==========
    Funções de suporte para exibir texto, medir temperatura e configurar PWM.
 */
@@ -29,14 +34,19 @@ void display_text(uint8_t *ssd, struct render_area *area, char *text[], int text
     render_on_display(ssd, area);
 }
 
-// Executa múltiplas leituras do ADC para calcular uma média e converter tensão em temperatura.
+// Calcula a média das leituras mais recentes do sensor (já capturadas pelo DMA) e converte tensão em temperatura.
 float leitura_temp_precisa(int nro_amostras) {
+    uint16_t amostras[TEMP_RING_SIZE];
+    if (nro_amostras > TEMP_RING_SIZE) nro_amostras = TEMP_RING_SIZE;
+
+    uint lidas = adc_stream_read_latest(ADC_STREAM_TEMP_CHANNEL, amostras, nro_amostras);
+    if (lidas == 0) return 0.0f;
+
     uint32_t soma = 0;
-    for (int i = 0; i < nro_amostras; i++) {
-        soma += adc_read();
-        sleep_us(50);
+    for (uint i = 0; i < lidas; i++) {
+        soma += amostras[i];
     }
-    float media = soma / (float)nro_amostras;
+    float media = soma / (float)lidas;
     float voltage = media * (3.3f / 4095);
     return 27.0f - ((voltage - 0.706f) / 0.001721f);
 }
@@ -85,10 +95,10 @@ bool temp_alert_callback(repeating_timer_t *rt) {
 int main() {
     stdio_init_all();
 
-    // Inicialização do ADC para sensor de temperatura
-    adc_init();
-    adc_set_temp_sensor_enabled(true);
-    adc_select_input(4);
+    // Inicialização do ADC para sensor de temperatura (amostrado continuamente pelo DMA)
+    adc_stream_init(TEMP_CLOCK_DIV);
+    adc_stream_add_channel(ADC_STREAM_TEMP_CHANNEL, temp_ring, TEMP_RING_SIZE, 1);
+    adc_stream_start();
 
     // Inicialização do I2C para comunicação com o display OLED
     i2c_init(i2c1, 400 * 1000);
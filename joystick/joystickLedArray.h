@@ -1,5 +1,5 @@
 #include "pico/stdlib.h"
-#include "hardware/adc.h"
+#include "adc_stream.h"
 #include "ledsArray.h"
 
 #define MATRIX_SIZE 5  // Matriz 5x5
@@ -9,6 +9,16 @@
 #define VRY_PIN 27  // Eixo Y (ADC1)
 #define SW_PIN 22   // Botão do joystick
 
+// Aquisição dos eixos pelo serviço compartilhado do ADC.
+#define JOY_CLOCK_DIV 47999.f // 48 MHz / (1 + 47999) = 1 kHz no round-robin (500 Hz por eixo)
+#define JOY_DECIMATION 10     // Média de 10 leituras: 50 Hz por eixo, com menos ruído
+// O CMakeLists.txt define ADC_STREAM_BLOCK=8: as leituras chegam aos buffers a
+// cada 8 ms, em vez de 128 ms com o bloco padrão.
+#define JOY_RING_SIZE 16
+
+uint16_t joy_x_ring[JOY_RING_SIZE];
+uint16_t joy_y_ring[JOY_RING_SIZE];
+
 // Posição do LED ativo (inicia no centro da matriz)
 int pos_x = 2, pos_y = 2;
 
@@ -23,11 +33,9 @@ int getLEDIndex(int x, int y) {
  * Atualiza a posição do LED com base no joystick.
  */
 void updateLEDPosition() {
-    adc_select_input(0);
-    uint16_t x_value = adc_read();
-    
-    adc_select_input(1);
-    uint16_t y_value = adc_read();
+    // Última leitura (já filtrada) de cada eixo, sem bloquear o ADC.
+    uint16_t x_value = adc_stream_latest(0);
+    uint16_t y_value = adc_stream_latest(1);
     
     bool button_pressed = !gpio_get(SW_PIN);
 
@@ -57,9 +65,11 @@ void updateLEDPosition() {
  * Inicializa o joystick.
  */
 void joystickInit() {
-    adc_init();
-    adc_gpio_init(VRX_PIN);
-    adc_gpio_init(VRY_PIN);
+    // ADC0 e ADC1 amostrados em round-robin pelo DMA.
+    adc_stream_init(JOY_CLOCK_DIV);
+    adc_stream_add_channel(0, joy_x_ring, JOY_RING_SIZE, JOY_DECIMATION);
+    adc_stream_add_channel(1, joy_y_ring, JOY_RING_SIZE, JOY_DECIMATION);
+    adc_stream_start();
 
     gpio_init(SW_PIN);
     gpio_set_dir(SW_PIN, GPIO_IN);
@@ -0,0 +1,93 @@
+/**
+ * @file auto_range.c
+ * @brief Implementação do piso de ruído (estatística de mínimos) e da escala automática
+ */
+
+#include "auto_range.h"
+#include "log2_q8.h"
+
+#define DC_SHIFT 10 // Constante de tempo do nível DC: 1024 amostras
+
+static uint32_t dc_acc;
+static uint32_t smooth;                    // Energia suavizada (contagens²)
+static uint32_t sub_min[AR_SUBWINDOWS];    // Mínimo de cada sub-janela anterior
+static uint sub_index;
+static uint32_t current_min;               // Mínimo da sub-janela em andamento
+static uint block_count;
+static uint32_t noise_floor;
+static uint32_t ceiling;
+
+void auto_range_init(void) {
+    dc_acc = ADC_SAMPLE_MID << DC_SHIFT;
+    smooth = 0;
+    sub_index = 0;
+    current_min = UINT32_MAX;
+    block_count = 0;
+    for (uint i = 0; i < AR_SUBWINDOWS; ++i)
+        sub_min[i] = UINT32_MAX;
+    noise_floor = 0;
+    ceiling = 0;
+}
+
+void auto_range_feed(const adc_sample_t *samples, uint count) {
+    if (count == 0)
+        return;
+
+    uint32_t sum = 0;
+    for (uint i = 0; i < count; ++i) {
+        int32_t dc = dc_acc >> DC_SHIFT;
+        int32_t dev = (int32_t)samples[i] - dc;
+        dc_acc += samples[i] - dc;
+        sum += (uint32_t)(dev * dev);
+    }
+    uint32_t energy = sum / count;
+
+    smooth += ((int32_t)energy - (int32_t)smooth) >> AR_SMOOTH_SHIFT;
+
+    // Estatística de mínimos: mínimo da sub-janela atual e das anteriores.
+    if (smooth < current_min)
+        current_min = smooth;
+    if (++block_count == AR_SUBWINDOW_BLOCKS) {
+        sub_min[sub_index] = current_min;
+        if (++sub_index == AR_SUBWINDOWS)
+            sub_index = 0;
+        current_min = UINT32_MAX;
+        block_count = 0;
+    }
+
+    uint32_t min = current_min;
+    for (uint i = 0; i < AR_SUBWINDOWS; ++i)
+        if (sub_min[i] < min)
+            min = sub_min[i];
+    noise_floor = (uint64_t)min * AR_FLOOR_BIAS_Q4 >> 4;
+
+    // Teto: ataque imediato, decaimento lento.
+    if (smooth > ceiling)
+        ceiling = smooth;
+    else
+        ceiling -= ceiling >> AR_CEIL_DECAY_SHIFT;
+}
+
+uint8_t auto_range_level(uint levels) {
+    int32_t zero = log2_q8(noise_floor) + AR_FLOOR_MARGIN_Q8;
+    int32_t top = log2_q8(ceiling);
+    if (top - zero < AR_MIN_RANGE_Q8)
+        top = zero + AR_MIN_RANGE_Q8; // Sala silenciosa: não amplifica o próprio ruído
+
+    int32_t now = log2_q8(smooth);
+    if (now <= zero)
+        return 0;
+
+    // Arredonda para cima: qualquer som acima do piso acende o primeiro nível,
+    // e o teto acende todos.
+    int32_t level = ((now - zero) * (int32_t)levels + (top - zero) - 1) / (top - zero);
+    return level > (int32_t)levels ? levels : level;
+}
+
+uint32_t auto_range_floor(void) {
+    return noise_floor;
+}
+
+uint32_t auto_range_ceiling(void) {
+    return ceiling;
+}
@@ -0,0 +1,56 @@
+/**
+ * @file auto_range.h
+ * @brief Estimativa do piso de ruído e ajuste automático da escala do medidor
+ *
+ * A cada bloco do fluxo do microfone calcula-se a energia (sem o nível DC),
+ * suavizada por um filtro IIR. Dela saem duas referências:
+ *  - piso de ruído por estatística de mínimos: o menor valor suavizado nos
+ *    últimos AR_SUBWINDOWS sub-janelas de AR_SUBWINDOW_BLOCKS blocos (~1,5 s),
+ *    corrigido pelo viés do mínimo;
+ *  - teto: pico da energia, que sobe na hora e decai devagar.
+ *
+ * O nível atual é mapeado em escala logarítmica (dB) entre o piso e o teto,
+ * de forma que a barra use toda a faixa em salas quietas ou barulhentas.
+ * Tudo é atualizado incrementalmente, bloco a bloco, em inteiros.
+ */
+
+#ifndef AUTO_RANGE_H
+#define AUTO_RANGE_H
+
+#include "pico/stdlib.h"
+#include "adc_stream.h"
+
+#define AR_SMOOTH_SHIFT 2        // Suavização da energia: 1/4 por bloco
+#define AR_SUBWINDOW_BLOCKS 32   // Blocos por sub-janela do mínimo (128 ms com blocos de 4 ms)
+#define AR_SUBWINDOWS 12         // Sub-janelas lembradas: piso segue o ruído em ~1,5 s
+#define AR_FLOOR_BIAS_Q4 24      // Correção do viés do mínimo (Q4: 24/16 = 1,5x)
+#define AR_FLOOR_MARGIN_Q8 256   // O nível zero começa 3 dB acima do piso (log2 da energia em Q8)
+#define AR_CEIL_DECAY_SHIFT 9    // Decaimento do teto: 1/512 por bloco (~2 s)
+#define AR_MIN_RANGE_Q8 1024     // Faixa mínima entre o zero e o teto: 12 dB (log2 da energia em Q8)
+
+/**
+ * @brief Reinicia o piso e o teto
+ */
+void auto_range_init(void);
+
+/**
+ * @brief Atualiza as estatísticas com um bloco de amostras do microfone
+ */
+void auto_range_feed(const adc_sample_t *samples, uint count);
+
+/**
+ * @brief Nível atual mapeado de 0 a levels entre o piso de ruído e o teto
+ */
+uint8_t auto_range_level(uint levels);
+
+/**
+ * @brief Piso de ruído estimado (energia média por amostra, contagens²)
+ */
+uint32_t auto_range_floor(void);
+
+/**
+ * @brief Teto atual da escala (energia média por amostra, contagens²)
+ */
+uint32_t auto_range_ceiling(void);
+
+#endif /* AUTO_RANGE_H */
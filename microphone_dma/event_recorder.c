@@ -0,0 +1,163 @@
+/**
+ * @file event_recorder.c
+ * @brief Implementação do gravador de eventos sonoros com pré-gatilho
+ */
+
+#include <stdio.h>
+#include "event_recorder.h"
+
+#define DC_SHIFT 10 // Constante de tempo do nível DC: 1024 amostras
+
+typedef enum {
+    REC_ARMED,     // Gravando continuamente, esperando o gatilho
+    REC_CAPTURING, // Gatilho ocorreu, completando a janela pós-gatilho
+    REC_FROZEN     // Janela completa, aguardando envio
+} rec_state_t;
+
+static adc_sample_t buffer[REC_BUFFER_SAMPLES];
+static uint write_pos;     // Próxima posição de escrita no buffer circular
+static uint filled;        // Amostras válidas no buffer (até o tamanho da janela)
+
+static uint pre_samples;   // Amostras mantidas antes do gatilho
+static uint window;        // Tamanho total da janela (pré + pós)
+static uint post_left;     // Amostras que faltam após o gatilho
+static uint32_t rate;
+static uint16_t trigger_level;
+static uint32_t dc_acc;    // Nível DC do microfone, em ponto fixo (<< DC_SHIFT)
+
+static rec_state_t state;
+static uint32_t event_id;
+static uint16_t event_peak;
+static uint64_t event_time_us;
+static uint event_pre;     // Amostras pré-gatilho realmente disponíveis no evento
+static uint send_pos;      // Próxima amostra do evento a ser enviada
+static bool header_sent;
+
+void event_recorder_init(uint32_t sample_rate, uint pre_ms, uint post_ms, uint16_t threshold) {
+    rate = sample_rate;
+    pre_samples = sample_rate * pre_ms / 1000;
+    uint post = sample_rate * post_ms / 1000;
+
+    // Limita a janela à capacidade do buffer, preservando a proporção pré/pós.
+    if (pre_samples + post > REC_BUFFER_SAMPLES) {
+        pre_samples = (uint64_t)pre_samples * REC_BUFFER_SAMPLES / (pre_samples + post);
+        post = REC_BUFFER_SAMPLES - pre_samples;
+    }
+    if (post == 0) post = 1;
+
+    window = pre_samples + post;
+    post_left = post;
+    trigger_level = threshold;
+    dc_acc = ADC_SAMPLE_MID << DC_SHIFT; // Offset de 1,65 V do microfone
+    write_pos = 0;
+    filled = 0;
+    event_id = 0;
+    state = REC_ARMED;
+}
+
+/**
+ * Início do evento congelado dentro do buffer circular.
+ */
+static inline uint event_start(void) {
+    uint count = event_pre + (window - pre_samples);
+    return (write_pos + REC_BUFFER_SAMPLES - count) % REC_BUFFER_SAMPLES;
+}
+
+void event_recorder_feed(const adc_sample_t *samples, uint count) {
+    if (state == REC_FROZEN)
+        return; // O evento anterior ainda está sendo enviado.
+
+    uint64_t now = time_us_64();
+
+    for (uint i = 0; i < count; ++i) {
+        adc_sample_t x = samples[i];
+
+        buffer[write_pos] = x;
+        if (++write_pos == REC_BUFFER_SAMPLES)
+            write_pos = 0;
+        if (filled < window)
+            ++filled;
+
+        // Desvio em relação ao nível DC (acompanhado por um filtro IIR de 1ª ordem).
+        int32_t dc = dc_acc >> DC_SHIFT;
+        int32_t dev = (int32_t)x - dc;
+        if (dev < 0) dev = -dev;
+        dc_acc += x - dc;
+
+        if (state == REC_ARMED) {
+            if (dev >= trigger_level) {
+                state = REC_CAPTURING;
+                post_left = window - pre_samples - 1; // A amostra do gatilho conta como pós
+                event_pre = (filled - 1 < pre_samples) ? filled - 1 : pre_samples;
+                event_peak = dev;
+                event_time_us = now - (uint64_t)(count - i) * 1000000u / rate;
+                if (post_left == 0)
+                    state = REC_FROZEN;
+            }
+        } else {
+            if (dev > event_peak)
+                event_peak = dev;
+            if (--post_left == 0) {
+                state = REC_FROZEN;
+                send_pos = 0;
+                header_sent = false;
+                return;
+            }
+        }
+    }
+
+    if (state == REC_FROZEN) {
+        send_pos = 0;
+        header_sent = false;
+    }
+}
+
+bool event_recorder_ready(void) {
+    return state == REC_FROZEN;
+}
+
+bool event_recorder_send(uint max_lines) {
+    if (state != REC_FROZEN)
+        return false;
+
+    uint total = event_pre + (window - pre_samples);
+    uint start = event_start();
+
+    if (!header_sent) {
+        printf("EVT:BEGIN %lu %lu %u %u %u %llu\r\n", (unsigned long)event_id, (unsigned long)rate,
+               event_pre, total, event_peak << ADC_SAMPLE_SHIFT, (unsigned long long)event_time_us);
+        header_sent = true;
+    }
+
+    static char line[16 + REC_LINE_SAMPLES * 3 + 3];
+    static const char hex[] = "0123456789ABCDEF";
+
+    while (max_lines-- > 0 && send_pos < total) {
+        uint n = total - send_pos;
+        if (n > REC_LINE_SAMPLES) n = REC_LINE_SAMPLES;
+
+        char *p = line;
+        for (uint i = 0; i < n; ++i) {
+            // Sempre enviado em 12-bits, qualquer que seja a largura da captura.
+            uint16_t s = buffer[(start + send_pos + i) % REC_BUFFER_SAMPLES] << ADC_SAMPLE_SHIFT;
+            *p++ = hex[(s >> 8) & 0xF];
+            *p++ = hex[(s >> 4) & 0xF];
+            *p++ = hex[s & 0xF];
+        }
+        *p = '\0';
+
+        printf("EVT:DATA %u %s\r\n", send_pos, line);
+        send_pos += n;
+    }
+
+    if (send_pos < total)
+        return false;
+
+    printf("EVT:END %lu\r\n", (unsigned long)event_id);
+
+    // Rearma: o conteúdo antigo não serve mais como pré-gatilho.
+    ++event_id;
+    filled = 0;
+    state = REC_ARMED;
+    return true;
+}
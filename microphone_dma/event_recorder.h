@@ -0,0 +1,56 @@
+/**
+ * @file event_recorder.h
+ * @brief Gravador de eventos sonoros com pré-gatilho
+ *
+ * O gravador mantém os últimos milissegundos de áudio do microfone em um
+ * buffer circular. Quando o nível do sinal ultrapassa o limiar, ele continua
+ * gravando até completar a janela pós-gatilho e então congela o buffer, que
+ * passa a conter o som com o contexto de antes e depois do disparo.
+ *
+ * O evento congelado é enviado ao computador pela serial em linhas de texto
+ * com o prefixo "EVT:", algumas linhas por chamada, sem travar o loop:
+ *
+ *   EVT:BEGIN <id> <taxa_hz> <amostras_pre> <amostras_total> <pico> <tempo_us>
+ *   EVT:DATA <posicao> <amostras em hexadecimal, 3 dígitos cada>
+ *   EVT:END <id>
+ */
+
+#ifndef EVENT_RECORDER_H
+#define EVENT_RECORDER_H
+
+#include "pico/stdlib.h"
+#include <stdbool.h>
+#include "adc_stream.h"
+
+#define REC_BUFFER_SAMPLES (16384 / sizeof(adc_sample_t)) // Capacidade da janela (pré + pós) em 16 KB
+#define REC_LINE_SAMPLES 64       // Amostras por linha EVT:DATA
+
+/**
+ * @brief Configura o gravador e o deixa armado
+ *
+ * @param sample_rate Taxa de amostragem do microfone em Hz
+ * @param pre_ms Duração guardada antes do gatilho
+ * @param post_ms Duração gravada depois do gatilho
+ * @param threshold Desvio mínimo em relação ao nível DC (contagens do ADC na largura atual) para disparar
+ */
+void event_recorder_init(uint32_t sample_rate, uint pre_ms, uint post_ms, uint16_t threshold);
+
+/**
+ * @brief Entrega um bloco de amostras do microfone ao gravador
+ */
+void event_recorder_feed(const adc_sample_t *samples, uint count);
+
+/**
+ * @brief Indica se existe um evento completo aguardando envio
+ */
+bool event_recorder_ready(void);
+
+/**
+ * @brief Envia parte do evento congelado pela serial
+ *
+ * @param max_lines Número máximo de linhas EVT:DATA enviadas nesta chamada
+ * @return true quando o evento terminou de ser enviado e o gravador foi rearmado
+ */
+bool event_recorder_send(uint max_lines);
+
+#endif /* EVENT_RECORDER_H */
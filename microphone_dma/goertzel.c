@@ -0,0 +1,115 @@
+/**
+ * @file goertzel.c
+ * @brief Implementação do banco de filtros de Goertzel em ponto fixo
+ */
+
+#include <math.h>
+#include "goertzel.h"
+
+#define COEFF_SHIFT 14 // Coeficientes em Q14 (2cos(w) vai de -2 a 2)
+#define DC_SHIFT 10    // Constante de tempo do nível DC: 1024 amostras
+
+typedef struct {
+    uint16_t freq;
+    int32_t coeff;   // 2cos(2*pi*f/fs) em Q14
+    int32_t s1, s2;  // Estado do filtro
+    uint16_t power;  // Resultado do último bloco (Q8)
+} goertzel_tone_t;
+
+static goertzel_tone_t tones[GOERTZEL_MAX_TONES];
+static uint tone_count;
+static uint32_t rate;
+static uint block;
+static uint block_pos;
+static uint64_t block_energy;  // Soma dos quadrados do bloco (sem DC)
+static uint32_t dc_acc;
+static bool done;
+
+void goertzel_init(uint32_t sample_rate, uint block_size) {
+    rate = sample_rate;
+    block = block_size;
+    tone_count = 0;
+    dc_acc = ADC_SAMPLE_MID << DC_SHIFT;
+    goertzel_reset();
+}
+
+int goertzel_add_tone(uint16_t freq_hz) {
+    if (tone_count >= GOERTZEL_MAX_TONES)
+        return -1;
+
+    // O coeficiente só é calculado em ponto flutuante uma vez, aqui.
+    goertzel_tone_t *t = &tones[tone_count];
+    t->freq = freq_hz;
+    t->coeff = (int32_t)lroundf(2.f * cosf(2.f * (float)M_PI * freq_hz / rate) * (1 << COEFF_SHIFT));
+    t->s1 = t->s2 = 0;
+    t->power = 0;
+    return tone_count++;
+}
+
+void goertzel_reset(void) {
+    for (uint i = 0; i < tone_count; ++i) {
+        tones[i].s1 = tones[i].s2 = 0;
+        tones[i].power = 0;
+    }
+    block_pos = 0;
+    block_energy = 0;
+    done = false;
+}
+
+/**
+ * Fim do bloco: potência de cada tom (|X(f)|²) normalizada pela energia total.
+ * Para um seno puro centrado no tom, 2|X|² / (N * energia) = 1.
+ */
+static void finish_block(void) {
+    for (uint i = 0; i < tone_count; ++i) {
+        goertzel_tone_t *t = &tones[i];
+        int64_t s1 = t->s1, s2 = t->s2;
+        int64_t mag2 = s1 * s1 + s2 * s2 - ((t->coeff * s1 >> COEFF_SHIFT) * s2);
+        if (mag2 < 0) mag2 = 0;
+
+        uint64_t den = (uint64_t)block * block_energy;
+        uint64_t power = den ? ((uint64_t)mag2 << 9) / den : 0; // 2 * 256 = 1 << 9
+        t->power = power > 256 ? 256 : power;
+
+        t->s1 = t->s2 = 0;
+    }
+
+    block_pos = 0;
+    block_energy = 0;
+    done = true;
+}
+
+void goertzel_feed(const adc_sample_t *samples, uint count) {
+    for (uint n = 0; n < count; ++n) {
+        int32_t dc = dc_acc >> DC_SHIFT;
+        int32_t x = (int32_t)samples[n] - dc;
+        dc_acc += samples[n] - dc;
+
+        block_energy += (uint32_t)(x * x);
+
+        // s[n] = x[n] + 2cos(w) s[n-1] - s[n-2]
+        for (uint i = 0; i < tone_count; ++i) {
+            goertzel_tone_t *t = &tones[i];
+            int32_t s = x + (int32_t)(((int64_t)t->coeff * t->s1) >> COEFF_SHIFT) - t->s2;
+            t->s2 = t->s1;
+            t->s1 = s;
+        }
+
+        if (++block_pos == block)
+            finish_block();
+    }
+}
+
+bool goertzel_block_done(void) {
+    bool d = done;
+    done = false;
+    return d;
+}
+
+uint16_t goertzel_power(uint index) {
+    return index < tone_count ? tones[index].power : 0;
+}
+
+uint16_t goertzel_freq(uint index) {
+    return index < tone_count ? tones[index].freq : 0;
+}
@@ -0,0 +1,64 @@
+/**
+ * @file goertzel.h
+ * @brief Banco de filtros de Goertzel em ponto fixo para detecção de tons
+ *
+ * Cada filtro mede a energia do sinal em uma única frequência, com custo de
+ * uma multiplicação por amostra, bem mais barato que uma FFT completa quando
+ * só interessam poucas frequências (notas do buzzer, tons de teste).
+ *
+ * As amostras são acumuladas em blocos de block_size amostras (resolução de
+ * sample_rate / block_size Hz). Ao fim de cada bloco, o resultado de cada tom
+ * é a fração da energia do bloco que está naquela frequência, em Q8
+ * (256 = toda a energia no tom).
+ */
+
+#ifndef GOERTZEL_H
+#define GOERTZEL_H
+
+#include "pico/stdlib.h"
+#include <stdbool.h>
+#include "adc_stream.h"
+
+#define GOERTZEL_MAX_TONES 8
+
+/**
+ * @brief Prepara o banco (remove todos os tons)
+ *
+ * @param sample_rate Taxa de amostragem do microfone em Hz
+ * @param block_size Amostras por bloco de análise
+ */
+void goertzel_init(uint32_t sample_rate, uint block_size);
+
+/**
+ * @brief Inclui um tom no banco
+ *
+ * @return Índice do tom, ou -1 se o banco estiver cheio
+ */
+int goertzel_add_tone(uint16_t freq_hz);
+
+/**
+ * @brief Descarta o bloco em andamento e os resultados anteriores
+ */
+void goertzel_reset(void);
+
+/**
+ * @brief Entrega amostras do microfone (adc_sample_t, na largura do ADC_STREAM_8BIT) ao banco
+ */
+void goertzel_feed(const adc_sample_t *samples, uint count);
+
+/**
+ * @brief Indica se um bloco foi concluído desde a última chamada (e limpa o aviso)
+ */
+bool goertzel_block_done(void);
+
+/**
+ * @brief Fração da energia do último bloco no tom indicado (Q8, 0 a 256)
+ */
+uint16_t goertzel_power(uint index);
+
+/**
+ * @brief Frequência de um tom do banco, em Hz
+ */
+uint16_t goertzel_freq(uint index);
+
+#endif /* GOERTZEL_H */
@@ -0,0 +1,25 @@
+/**
+ * @file log2_q8.h
+ * @brief log2 inteiro em Q8, base das escalas em dB (auto_range, spectrogram)
+ */
+
+#ifndef LOG2_Q8_H
+#define LOG2_Q8_H
+
+#include "pico/stdlib.h"
+
+/**
+ * @brief log2 de x em Q8 (256 = dobro da potência, ~3 dB)
+ *
+ * A mantissa é aproximada de forma linear (erro < 0,09 em log2). log2_q8(0) = 0.
+ */
+static inline int32_t log2_q8(uint32_t x) {
+    if (x == 0)
+        return 0;
+
+    int msb = 31 - __builtin_clz(x);
+    uint32_t frac = msb >= 8 ? (x >> (msb - 8)) & 0xFF : (x << (8 - msb)) & 0xFF;
+    return (msb << 8) | frac;
+}
+
+#endif /* LOG2_Q8_H */
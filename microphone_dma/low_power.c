@@ -0,0 +1,63 @@
+/**
+ * @file low_power.c
+ * @brief Implementação da espera com WFI e da contagem de tempo dormindo
+ */
+
+#include "low_power.h"
+#include "adc_stream.h"
+#include "hardware/sync.h"
+
+static uint64_t idle_us;        // Tempo dormindo desde o último relatório
+static uint64_t report_start;   // Início do intervalo do relatório
+
+/**
+ * Dorme até a próxima interrupção, se cond ainda for falsa.
+ * As interrupções ficam mascaradas entre o teste e o WFI: uma interrupção que
+ * chegue nesse meio tempo fica pendente e faz o WFI retornar na hora, em vez
+ * de dormir até a seguinte.
+ */
+#define SLEEP_WHILE(cond)                                   \
+    do {                                                    \
+        uint32_t irq_state = save_and_disable_interrupts(); \
+        if (cond) {                                         \
+            uint64_t t0 = time_us_64();                     \
+            __wfi();                                        \
+            idle_us += time_us_64() - t0;                   \
+        }                                                   \
+        restore_interrupts(irq_state);                      \
+    } while (0)
+
+void low_power_wait_samples(uint channel, uint count) {
+    while (adc_stream_available(channel) < count) {
+#if LOW_POWER_WFI
+        SLEEP_WHILE(adc_stream_available(channel) < count);
+#else
+        tight_loop_contents();
+#endif
+    }
+}
+
+static int64_t wake_alarm(alarm_id_t id, void *user_data) {
+    return 0; // Só acorda o núcleo; não repete
+}
+
+void low_power_sleep_until(uint64_t time_us) {
+    if (time_us_64() >= time_us)
+        return;
+
+    add_alarm_at(from_us_since_boot(time_us), wake_alarm, NULL, true);
+    while (time_us_64() < time_us) {
+        // Outras interrupções (USB) também acordam o núcleo: volta a dormir.
+        SLEEP_WHILE(time_us_64() < time_us);
+    }
+}
+
+uint low_power_active_permille(void) {
+    uint64_t now = time_us_64();
+    uint64_t total = now - report_start;
+    uint permille = total ? 1000 - (uint)(idle_us * 1000 / total) : 1000;
+
+    report_start = now;
+    idle_us = 0;
+    return permille;
+}
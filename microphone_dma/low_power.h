@@ -0,0 +1,36 @@
+/**
+ * @file low_power.h
+ * @brief Espera com o núcleo dormindo (WFI) e medição da fração de tempo com a CPU ativa
+ *
+ * Em vez de girar em espera ativa, o núcleo executa WFI e só acorda na
+ * próxima interrupção: a do DMA do adc_stream (a cada ADC_STREAM_BLOCK
+ * amostras) durante a captura, ou um alarme do timer entre janelas do ciclo
+ * de trabalho. O tempo passado dormindo é somado para calcular a CPU ativa,
+ * usada para dimensionar baterias de monitores de ruído em campo.
+ */
+
+#ifndef LOW_POWER_H
+#define LOW_POWER_H
+
+#include "pico/stdlib.h"
+
+#define LOW_POWER_WFI 1 // 0: espera ativa pelas amostras (como antes), para comparar o consumo
+
+/**
+ * @brief Espera até haver count amostras no canal do adc_stream
+ *
+ * Não deve ser chamada com o fluxo parado.
+ */
+void low_power_wait_samples(uint channel, uint count);
+
+/**
+ * @brief Dorme até o instante time_us (time_us_64), acordado por um alarme do timer
+ */
+void low_power_sleep_until(uint64_t time_us);
+
+/**
+ * @brief CPU ativa desde a chamada anterior, em milésimos (1000 = nunca dormiu)
+ */
+uint low_power_active_permille(void);
+
+#endif /* LOW_POWER_H */
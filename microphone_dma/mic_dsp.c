@@ -0,0 +1,94 @@
+/**
+ * @file mic_dsp.c
+ * @brief Implementação da cadeia de processamento do microfone
+ */
+
+#include <math.h>
+#include "mic_dsp.h"
+#include "adc_stream.h"
+#include "event_recorder.h"
+#include "pitch_tracker.h"
+#include "auto_range.h"
+#include "low_power.h"
+#include "noise_level.h"
+#include "spectrogram.h"
+#include "sound_classifier.h"
+
+// Buffer circular preenchido continuamente pelo serviço de aquisição (adc_stream).
+static adc_sample_t mic_ring[MIC_RING_SIZE];
+
+// Buffer de amostras do ADC: janela deslizante com as SAMPLES amostras mais recentes.
+static adc_sample_t adc_buffer[SAMPLES];
+static uint adc_buffer_pos;
+
+// Bloco lido do fluxo do microfone a cada passo.
+static adc_sample_t mic_hop[MIC_HOP];
+
+void mic_dsp_init(void) {
+  adc_stream_add_channel(MIC_CHANNEL, mic_ring, MIC_RING_SIZE, 1);
+
+  event_recorder_init(MIC_SAMPLE_RATE, REC_PRE_MS, REC_POST_MS, ADC_LEVEL(REC_THRESHOLD));
+  onset_detector_init(MIC_SAMPLE_RATE);
+  pitch_tracker_init(MIC_SAMPLE_RATE);
+  auto_range_init();
+
+  noise_level_init(MIC_SAMPLE_RATE);
+  noise_level_add_interval(LEVEL_SHORT_MS);
+  noise_level_add_interval(LEVEL_LONG_MS);
+
+  spectrogram_init();
+  sound_classifier_init(MIC_SAMPLE_RATE);
+}
+
+void sample_mic(void) {
+  // Dorme até o DMA entregar o próximo bloco.
+  low_power_wait_samples(MIC_CHANNEL, MIC_HOP);
+
+  while (adc_stream_available(MIC_CHANNEL) >= MIC_HOP) {
+    adc_stream_read(MIC_CHANNEL, mic_hop, MIC_HOP);
+
+    // Instante da última amostra do bloco: agora menos o que ainda está no buffer.
+    uint64_t fim_bloco = time_us_64() -
+      (uint64_t)adc_stream_available(MIC_CHANNEL) * 1000000u / MIC_SAMPLE_RATE;
+
+    event_recorder_feed(mic_hop, MIC_HOP);
+    onset_detector_feed(mic_hop, MIC_HOP, fim_bloco);
+    pitch_tracker_feed(mic_hop, MIC_HOP);
+    auto_range_feed(mic_hop, MIC_HOP);
+    noise_level_feed(mic_hop, MIC_HOP);
+    spectrogram_feed(mic_hop, MIC_HOP);
+
+    // Cada quadro novo do espectrograma (12,5 ms) passa pelo classificador de sons.
+    const uint16_t *quadro = spectrogram_new_frame();
+    if (quadro)
+      sound_classifier_feed(quadro, fim_bloco);
+
+    for (uint i = 0; i < MIC_HOP; ++i) {
+      adc_buffer[adc_buffer_pos] = mic_hop[i];
+      if (++adc_buffer_pos == SAMPLES) adc_buffer_pos = 0;
+    }
+  }
+}
+
+/**
+ * Calcula a potência média das leituras do ADC. (Valor RMS)
+ * A ordem das amostras na janela não importa para o cálculo.
+ */
+float mic_power(void) {
+  float avg = 0.f;
+
+  for (uint i = 0; i < SAMPLES; ++i)
+    avg += adc_buffer[i] * adc_buffer[i];
+  
+  avg /= SAMPLES;
+  return sqrt(avg);
+}
+
+/**
+ * Calcula a intensidade do volume registrado no microfone.
+ * A escala se ajusta sozinha: o nível 0 fica logo acima do piso de ruído
+ * estimado e o nível máximo acompanha o pico recente (ver auto_range.h).
+ */
+uint8_t get_intensity(void) {
+  return auto_range_level(MIC_LEVELS);
+}
@@ -0,0 +1,68 @@
+/**
+ * @file mic_dsp.h
+ * @brief Cadeia de processamento do microfone: do fluxo do adc_stream à intensidade do medidor
+ *
+ * Reúne o consumo do fluxo (sample_mic), a janela do medidor (mic_power) e a
+ * escala da barra (get_intensity), além de alimentar o gravador de eventos e
+ * os detectores de batida e de altura, o medidor de nível, o espectrograma e
+ * o classificador de sons. Não depende da matriz nem da serial, e
+ * só fala com o hardware através do adc_stream.h: por isso compila também no
+ * PC, contra um adc_stream simulado (ver test/).
+ */
+
+#ifndef MIC_DSP_H
+#define MIC_DSP_H
+
+#include "pico/stdlib.h"
+#include "adc_stream.h"
+#include "onset_detector.h"
+
+// Pino e canal do microfone no ADC.
+#define MIC_CHANNEL 2
+#define MIC_PIN (26 + MIC_CHANNEL)
+
+#define MIC_SAMPLE_RATE 16000 // Taxa de amostragem contínua do microfone (Hz).
+#define SAMPLES 200 // Número de amostras da janela do medidor.
+#define MIC_HOP ONSET_HOP // Amostras consumidas do fluxo por vez (4 ms a 16 kHz).
+#define MIC_RING_SIZE (8192 / sizeof(adc_sample_t)) // Buffer circular do microfone em 8 KB: 256 ms em 12-bits, 512 ms em 8-bits.
+#define MIC_LEVELS 5 // Níveis da barra (linhas da matriz).
+
+// Gravador de eventos: janela guardada em volta de sons altos.
+#define REC_PRE_MS 200 // Áudio mantido antes do gatilho
+#define REC_POST_MS 300 // Áudio gravado depois do gatilho
+#define REC_THRESHOLD 900 // Desvio do nível DC para disparar (contagens de 12-bits, ~0,72 V)
+
+// Medidor de nível com ponderação A (noise_level): intervalos 0 e 1.
+#define LEVEL_SHORT_MS 1000 // Leq/Lmax/Lmin a cada segundo
+#define LEVEL_LONG_MS 60000 // e a cada minuto
+#define LEVEL_INTERVALS 2
+
+/**
+ * @brief Registra o microfone no adc_stream e prepara os analisadores
+ *
+ * Deve ser chamada depois de adc_stream_init() e antes de adc_stream_start().
+ */
+void mic_dsp_init(void);
+
+/**
+ * @brief Consome as amostras novas do microfone em blocos de MIC_HOP amostras
+ *
+ * Espera, dormindo (ver low_power.h), até haver ao menos um bloco. Cada
+ * bloco passa pelo gravador de eventos, pelos detectores, pela escala
+ * automática, pelo medidor de nível e pelo espectrograma (e cada quadro
+ * dele pelo classificador de sons), e entra na janela deslizante usada
+ * pelo medidor.
+ */
+void sample_mic(void);
+
+/**
+ * @brief Potência média (RMS, em contagens do ADC na largura atual) da janela de SAMPLES amostras
+ */
+float mic_power(void);
+
+/**
+ * @brief Intensidade do volume, de 0 a MIC_LEVELS
+ */
+uint8_t get_intensity(void);
+
+#endif /* MIC_DSP_H */
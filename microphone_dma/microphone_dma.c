@@ -1,20 +1,23 @@
 #include <stdio.h>
 #include <math.h>
 #include "pico/stdlib.h"
-#include "hardware/adc.h"
-#include "hardware/dma.h"
+#include "adc_stream.h"
+#include "mic_dsp.h"
+#include "event_recorder.h"
+#include "onset_detector.h"
+#include "pitch_tracker.h"
+#include "auto_range.h"
+#include "low_power.h"
+#include "noise_level.h"
+#include "spectrogram.h"
+#include "sound_classifier.h"
+#include "self_test.h"
 #include "neoPixel.c"
 
-// Pino e canal do microfone no ADC.
-#define MIC_CHANNEL 2
-#define MIC_PIN (26 + MIC_CHANNEL)
-
-// Parâmetros e macros do ADC.
-#define ADC_CLOCK_DIV 96.f
-#define SAMPLES 200 // Número de amostras que serão feitas do ADC.
-#define ADC_ADJUST(x) (x * 3.3f / (1 << 12u) - 1.65f) // Ajuste do valor do ADC para Volts.
+// Parâmetros e macros do ADC (canal, taxa e janela do microfone em mic_dsp.h).
+#define ADC_CLOCK_DIV (48000000.f / MIC_SAMPLE_RATE - 1.f) // 48 MHz / (1 + 2999) = 16 kHz.
+#define ADC_ADJUST(x) (x * 3.3f / (1 << ADC_SAMPLE_BITS) - 1.65f) // Ajuste do valor do ADC para Volts.
 #define ADC_MAX 3.3f
-#define ADC_STEP (3.3f/5.f) // Intervalos de volume do microfone.
 
 // Pino e número de LEDs da matriz de LEDs.
 #define LED_PIN 7
@@ -25,19 +28,30 @@
 
 #define abs(x) ((x < 0) ? (-x) : (x))
 
-// Define DEBUG para gerar menos mensagens de depuração
-#define DEBUG_INTERVAL 100 // Aumentado de 20 para 100 ciclos para reduzir logs
+// Gravador de eventos (janela e gatilho em mic_dsp.h).
+#define REC_LINES_PER_LOOP 8 // Linhas do evento enviadas a cada atualização do medidor
 
-// Canal e configurações do DMA
-uint dma_channel;
-dma_channel_config dma_cfg;
+// Botão A da BitDogLab: inicia o autoteste buzzer -> microfone.
+#define BUTTON_A_PIN 5
 
-// Buffer de amostras do ADC.
-uint16_t adc_buffer[SAMPLES];
+// Intervalo entre atualizações do medidor (linha na serial e barra na matriz).
+#define METER_INTERVAL_US 50000
+#define METER_RAW_LINES 1 // 0: não envia a linha do medidor a cada 50 ms, só os níveis (LEQ)
+#ifndef SPECTROGRAM_FRAMES
+#define SPECTROGRAM_FRAMES 0 // 1: envia as colunas binárias do espectrograma (CMake: -DMIC_SPECTROGRAM_FRAMES=1)
+#endif
 
-void sample_mic();
-float mic_power();
-uint8_t get_intensity(float v);
+// Efeito de batida: borda da matriz pisca e apaga em BEAT_FLASH_US.
+#define BEAT_FLASH_US 150000
+#define BEAT_FLASH_STEP_US 15000 // Redesenha o efeito a cada 15 ms enquanto apaga
+
+// Ciclo de trabalho: captura DUTY_ON_MS a cada DUTY_PERIOD_MS e dorme no resto
+// (ADC, DMA e matriz desligados). Com os dois iguais a captura é contínua.
+#define DUTY_ON_MS 1000
+#define DUTY_PERIOD_MS 1000
+
+// Define DEBUG para gerar menos mensagens de depuração
+#define DEBUG_INTERVAL 100 // Aumentado de 20 para 100 ciclos para reduzir logs
 
 // Função que acende uma linha até o LED de índice fornecido
 void acendendoLinha(uint ledIndex, uint colorR, uint colorG, uint colorB) {
@@ -103,6 +117,25 @@ void acendeLinhaEscada(uint row, uint numLEDs, uint8_t colorR, uint8_t colorG, u
     }
 }
 
+/**
+ * Índice do LED na linha e coluna dadas, respeitando o padrão zigzag.
+ */
+uint indiceLED(uint row, uint col) {
+    return (row % 2 == 0) ? row * MATRIX_COLS + col : (row + 1) * MATRIX_COLS - 1 - col;
+}
+
+/**
+ * Acende a borda da matriz em magenta com o brilho fornecido (efeito de batida).
+ */
+void desenhaBatida(uint8_t brilho) {
+    for (uint row = 0; row < MATRIX_ROWS; row++) {
+        for (uint col = 0; col < MATRIX_COLS; col++) {
+            if (row == 0 || row == MATRIX_ROWS - 1 || col == 0 || col == MATRIX_COLS - 1)
+                npSetLED(indiceLED(row, col), brilho, 0, brilho);
+        }
+    }
+}
+
 /**
  * Acende uma barra vertical de LEDs em formato de escadinha.
  * Para cada intensidade:
@@ -111,11 +144,16 @@ void acendeLinhaEscada(uint row, uint numLEDs, uint8_t colorR, uint8_t colorG, u
  * 3 - Acende também a terceira linha com 3 LEDs
  * 4 - Acende também a quarta linha com 2 LEDs
  * 5 - Acende também a quinta linha com 1 LED
+ *
+ * Se brilho_batida for maior que zero, a borda da matriz é desenhada antes,
+ * por baixo da barra, com o efeito de batida.
  */
-void lightVerticalBar(uint intensity) {
+void lightVerticalBar(uint intensity, uint8_t brilho_batida) {
     // Limpa a matriz antes
     npClear();
     
+    if (brilho_batida > 0) desenhaBatida(brilho_batida);
+    
     // Limita a intensidade ao máximo de 5 níveis
     if (intensity > 5) intensity = 5;
     
@@ -130,6 +168,16 @@ void lightVerticalBar(uint intensity) {
     npWrite();
 }
 
+/**
+ * Brilho atual do efeito de batida: começa proporcional à força da batida
+ * e cai linearmente até zero em BEAT_FLASH_US.
+ */
+uint8_t brilhoBatida(uint64_t agora, uint64_t inicio, uint8_t brilho_inicial) {
+    uint64_t passado = agora - inicio;
+    if (passado >= BEAT_FLASH_US) return 0;
+    return brilho_inicial - (uint8_t)(brilho_inicial * passado / BEAT_FLASH_US);
+}
+
 int main() {
   stdio_init_all();
 
@@ -142,37 +190,21 @@ int main() {
   npInit(LED_PIN, LED_COUNT);
 
   // Preparação do ADC.
-  printf("Preparando ADC...\n");
-
-  adc_gpio_init(MIC_PIN);
-  adc_init();
-  adc_select_input(MIC_CHANNEL);
-
-  adc_fifo_setup(
-    true, // Habilitar FIFO
-    true, // Habilitar request de dados do DMA
-    1, // Threshold para ativar request DMA é 1 leitura do ADC
-    false, // Não usar bit de erro
-    false // Não fazer downscale das amostras para 8-bits, manter 12-bits.
-  );
-
-  adc_set_clkdiv(ADC_CLOCK_DIV);
-
-  printf("ADC Configurado!\n\n");
+  printf("Preparando ADC e DMA...\n");
 
-  printf("Preparando DMA...\n");
+  // O microfone é lido pelo serviço compartilhado de aquisição: o ADC roda
+  // continuamente e o DMA preenche o buffer circular do canal em segundo plano.
+  adc_stream_init(ADC_CLOCK_DIV);
+  mic_dsp_init();
+  adc_stream_start();
 
-  // Tomando posse de canal do DMA.
-  dma_channel = dma_claim_unused_channel(true);
+  printf("ADC Configurado! Microfone a %.0f Hz\n\n", adc_stream_rate(MIC_CHANNEL));
 
-  // Configurações do DMA.
-  dma_cfg = dma_channel_get_default_config(dma_channel);
-
-  channel_config_set_transfer_data_size(&dma_cfg, DMA_SIZE_16); // Tamanho da transferência é 16-bits
-  channel_config_set_read_increment(&dma_cfg, false); // Desabilita incremento do ponteiro de leitura
-  channel_config_set_write_increment(&dma_cfg, true); // Habilita incremento do ponteiro de escrita
-  
-  channel_config_set_dreq(&dma_cfg, DREQ_ADC); // Usamos a requisição de dados do ADC
+  // Buzzer e botão usados no autoteste.
+  buzzer_init();
+  gpio_init(BUTTON_A_PIN);
+  gpio_set_dir(BUTTON_A_PIN, GPIO_IN);
+  gpio_pull_up(BUTTON_A_PIN);
 
   // Amostragem de teste.
   printf("Amostragem de teste...\n");
@@ -181,87 +213,126 @@ int main() {
   printf("Configuracoes completas!\n");
 
   printf("\n----\nIniciando loop...\n----\n");
+
+  uint64_t proximo_medidor = time_us_64();
+  uint64_t inicio_janela = proximo_medidor;
+  uint64_t proximo_efeito = 0;
+  uint64_t inicio_batida = 0;
+  uint8_t brilho_inicial = 0;
+  uint intensity_mapped = 0;
+  float last_avg = 0;
+  bool nota_anterior = false;
+
+  // O loop roda a cada bloco de MIC_HOP amostras (4 ms): batidas chegam à matriz
+  // no mesmo bloco em que são detectadas, e o medidor continua a cada 50 ms.
   while (true) {
-    // Realiza uma amostragem do microfone.
+    // Fim da janela de captura: desliga a aquisição e dorme até a próxima.
+    if (DUTY_PERIOD_MS > DUTY_ON_MS && time_us_64() - inicio_janela >= DUTY_ON_MS * 1000u) {
+      adc_stream_stop();
+      lightVerticalBar(0, 0);
+      inicio_janela += DUTY_PERIOD_MS * 1000u;
+      low_power_sleep_until(inicio_janela);
+      adc_stream_start();
+    }
+
+    // Botão A pressionado: autoteste buzzer -> microfone (bloqueia por ~1,5 s).
+    if (!gpio_get(BUTTON_A_PIN)) {
+      lightVerticalBar(0, 0);
+      self_test_run(MIC_CHANNEL, MIC_SAMPLE_RATE);
+      while (!gpio_get(BUTTON_A_PIN)) sleep_ms(10); // Espera soltar o botão
+    }
+
+    // Consome o fluxo do microfone (gravador de eventos, detector de batidas e janela do medidor).
     sample_mic();
 
-    // Pega a potência média da amostragem do microfone.
-    float avg = mic_power();
-    avg = 2.f * abs(ADC_ADJUST(avg)); // Ajusta para intervalo de 0 a 3.3V.
+    uint64_t agora = time_us_64();
+    bool redesenhar = false;
 
-    // Aplicar uma pequena estabilização ao valor para evitar flutuações rápidas
-    static float last_avg = 0;
-    avg = (avg * 0.7f) + (last_avg * 0.3f); // Média ponderada: 70% atual, 30% anterior
-    last_avg = avg;
+    onset_event_t batida;
+    if (onset_detector_poll(&batida)) {
+      // Força 3x (limiar) a ~10x da média vira brilho de 40 a 120.
+      uint strength = batida.strength > 160 ? 160 : batida.strength;
+      brilho_inicial = 40 + (strength - ONSET_RATIO_Q4) * 80 / (160 - ONSET_RATIO_Q4);
+      inicio_batida = agora;
+      redesenhar = true;
 
-    uint intensity = get_intensity(avg);
-    uint intensity_mapped = (intensity > 5 ? 5 : intensity);
-    
-    lightVerticalBar(intensity_mapped);
+      printf("BEAT: %llu %u\r\n", (unsigned long long)batida.time_us, batida.strength);
+    }
 
-    // Formato simplificado e consistente
-    printf("%d %.4f\r\n", intensity, avg);
-    
-    // Reduzir número de mensagens de debug
-    static uint32_t debug_counter = 0;
-    if (++debug_counter % DEBUG_INTERVAL == 0) {  // Intervalo maior
-        printf("DEBUG: Ciclo %lu\r\n", debug_counter);
+    // Altura do som (YIN) a 25 Hz: nota e desvio em cents enquanto houver nota,
+    // e uma única linha REST quando ela acaba.
+    pitch_result_t pitch;
+    if (pitch_tracker_poll(&pitch) && (pitch.voiced || nota_anterior)) {
+      char nota[8];
+      pitch_note_name(pitch.voiced ? pitch.midi : 0, nota, sizeof(nota));
+      printf("PITCH: %s %+d %.1f %u\r\n", nota, pitch.cents, pitch.freq_hz, pitch.clarity_q12);
+      nota_anterior = pitch.voiced;
     }
-    
-    sleep_ms(50);
-  }
-}
 
-/**
- * Realiza as leituras do ADC e armazena os valores no buffer.
- */
-void sample_mic() {
-  adc_fifo_drain(); // Limpa o FIFO do ADC.
-  adc_run(false); // Desliga o ADC (se estiver ligado) para configurar o DMA.
-
-  dma_channel_configure(dma_channel, &dma_cfg,
-    adc_buffer, // Escreve no buffer.
-    &(adc_hw->fifo), // Lê do ADC.
-    SAMPLES, // Faz SAMPLES amostras.
-    true // Liga o DMA.
-  );
-
-  // Liga o ADC e espera acabar a leitura.
-  adc_run(true);
-  dma_channel_wait_for_finish_blocking(dma_channel);
-  
-  // Acabou a leitura, desliga o ADC de novo.
-  adc_run(false);
-}
+    // Sons reconhecidos (palma, assobio, batida na porta): um evento por ocorrência.
+    sound_event_t som;
+    if (sound_classifier_poll(&som))
+      printf("SOUND: %llu %d %s %u\r\n", (unsigned long long)som.time_us, som.id,
+             sound_class_name(som.id), som.confidence);
+
+    // Níveis com ponderação A ao fim de cada intervalo (1 s e 1 min), em dB.
+    for (uint i = 0; i < LEVEL_INTERVALS; ++i) {
+      noise_level_t nivel;
+      if (noise_level_poll(i, &nivel))
+        printf("LEQ: %lu %.1f %.1f %.1f\r\n", (unsigned long)(nivel.interval_ms / 1000),
+               nivel.leq_db, nivel.lmax_db, nivel.lmin_db);
+    }
 
-/**
- * Calcula a potência média das leituras do ADC. (Valor RMS)
- */
-float mic_power() {
-  float avg = 0.f;
+    // Coluna do espectrograma a cada 50 ms, como quadro binário (ver spectrogram.h).
+    uint8_t coluna[SPEC_BINS];
+    if (spectrogram_poll(coluna) && SPECTROGRAM_FRAMES)
+      spectrogram_send(coluna);
 
-  for (uint i = 0; i < SAMPLES; ++i)
-    avg += adc_buffer[i] * adc_buffer[i];
-  
-  avg /= SAMPLES;
-  return sqrt(avg);
-}
+    if (agora >= proximo_medidor) {
+      proximo_medidor += METER_INTERVAL_US;
+      if (agora >= proximo_medidor) proximo_medidor = agora + METER_INTERVAL_US;
 
-/**
- * Calcula a intensidade do volume registrado no microfone.
- * Versão melhorada para maior precisão.
- */
-uint8_t get_intensity(float v) {
-  uint count = 0;
-  
-  // Ajuste para tornar mais sensível a sons baixos
-  const float step_size = ADC_STEP/20;
-  const float threshold = 0.1f; // Valor mínimo para considerar som
-  
-  if (v < threshold) return 0;  // Ignorar valores muito baixos (ruído)
-  
-  while ((v -= step_size) > 0.f && count < 255)
-    ++count;
-  
-  return count;
+      // Pega a potência média da amostragem do microfone.
+      float avg = mic_power();
+      avg = 2.f * abs(ADC_ADJUST(avg)); // Ajusta para intervalo de 0 a 3.3V.
+
+      // Aplicar uma pequena estabilização ao valor para evitar flutuações rápidas
+      avg = (avg * 0.7f) + (last_avg * 0.3f); // Média ponderada: 70% atual, 30% anterior
+      last_avg = avg;
+
+      // Intensidade relativa ao piso de ruído e ao teto da escala automática.
+      uint intensity = get_intensity();
+      intensity_mapped = (intensity > 5 ? 5 : intensity);
+      redesenhar = true;
+
+      // Formato simplificado e consistente
+      if (METER_RAW_LINES)
+        printf("%d %.4f\r\n", intensity, avg);
+
+      // Envia aos poucos o último evento gravado, sem travar o loop.
+      if (event_recorder_ready())
+        event_recorder_send(REC_LINES_PER_LOOP);
+
+      // Reduzir número de mensagens de debug
+      static uint32_t debug_counter = 0;
+      if (++debug_counter % DEBUG_INTERVAL == 0) {  // Intervalo maior
+        printf("DEBUG: Ciclo %lu\r\n", debug_counter);
+        printf("DEBUG: Piso %lu Teto %lu\r\n", (unsigned long)auto_range_floor(), (unsigned long)auto_range_ceiling());
+
+        // CPU ativa no intervalo (dimensionamento de bateria) e ciclo de captura.
+        uint ativo = low_power_active_permille();
+        printf("DEBUG: CPU ativa %u.%u%% (captura %u%%)\r\n", ativo / 10, ativo % 10,
+               DUTY_ON_MS * 100u / DUTY_PERIOD_MS);
+      }
+    }
+
+    // Enquanto o efeito de batida apaga, redesenha em passos curtos.
+    uint8_t brilho = brilhoBatida(agora, inicio_batida, brilho_inicial);
+    if (brilho > 0 && agora >= proximo_efeito) redesenhar = true;
+
+    if (redesenhar) {
+      lightVerticalBar(intensity_mapped, brilho);
+      proximo_efeito = agora + BEAT_FLASH_STEP_US;
+    }
+  }
 }
@@ -0,0 +1,202 @@
+/**
+ * @file noise_level.c
+ * @brief Implementação do filtro de ponderação A e da integração dos níveis
+ */
+
+#include <math.h>
+#include "noise_level.h"
+
+#define COEFF_SHIFT 28          // Coeficientes dos polos em Q28
+#define INPUT_SHIFT (4 + ADC_SAMPLE_SHIFT) // Entrada em contagens de 12-bits com 4 bits de fração
+#define WARMUP_FAST 4           // Constantes de tempo ignoradas no início (transitório do filtro)
+
+// Polos do filtro analógico da curva A (Hz): 20,6 (duplo), 107,7, 737,9 e 12194 (duplo).
+#define POLE_F1 20.598997f
+#define POLE_F2 107.65265f
+#define POLE_F3 737.86223f
+#define POLE_F4 12194.217f
+
+/**
+ * Biquad em forma direta I. Os zeros da curva A caem em z = 1 (quatro zeros
+ * em s = 0) e em z = -1 (vindos da bilinear), então o numerador é fixo:
+ * 1 - 2z^-1 + z^-2 ou 1 + 2z^-1 + z^-2, sem multiplicações.
+ */
+typedef struct {
+    int32_t a1, a2;     // Denominador em Q28
+    int32_t zero_sign;  // -1: zeros em z = 1 (passa-altas), +1: zeros em z = -1
+    int32_t x1, x2, y1, y2;
+} biquad_t;
+
+typedef struct {
+    uint32_t length;    // Amostras por intervalo
+    uint32_t count;
+    uint64_t sum;       // Soma da energia do intervalo
+    uint64_t max, min;  // Extremos do acumulador Fast
+    noise_level_t result;
+    bool pending;
+} interval_t;
+
+static biquad_t stages[3];
+static int32_t gain_q28;        // Ganho que leva a resposta a 0 dB em 1 kHz
+static uint32_t rate;
+static uint fast_shift;         // Fast: média exponencial com peso 2^-fast_shift por amostra
+static uint64_t fast_acc;       // Energia Fast em ponto fixo (<< fast_shift)
+static uint32_t warmup;
+
+static interval_t intervals[NOISE_MAX_INTERVALS];
+static uint interval_count;
+
+// Energia de um seno de fundo de escala na escala do filtro: (2048 << 4)² / 2.
+static const float full_scale_energy = (float)(1u << 29);
+
+/**
+ * Polo analógico s = -2*pi*f levado ao plano z pela bilinear (sem pré-distorção).
+ */
+static float bilinear_pole(float f) {
+    float k = 2.f * (float)M_PI * f / (2.f * rate);
+    return (1.f - k) / (1.f + k);
+}
+
+static void set_stage(biquad_t *s, float p, float q, int32_t zero_sign) {
+    s->a1 = (int32_t)lroundf(-(p + q) * (1 << COEFF_SHIFT));
+    s->a2 = (int32_t)lroundf(p * q * (1 << COEFF_SHIFT));
+    s->zero_sign = zero_sign;
+    s->x1 = s->x2 = s->y1 = s->y2 = 0;
+}
+
+/**
+ * Módulo da resposta de um biquad na frequência f, calculado em ponto flutuante.
+ */
+static float stage_gain(const biquad_t *s, float f) {
+    float w = 2.f * (float)M_PI * f / rate;
+    float c1 = cosf(w), s1 = sinf(w), c2 = cosf(2.f * w), s2 = sinf(2.f * w);
+    float a1 = (float)s->a1 / (1 << COEFF_SHIFT), a2 = (float)s->a2 / (1 << COEFF_SHIFT);
+    float b1 = 2.f * s->zero_sign;
+
+    float nr = 1.f + b1 * c1 + c2, ni = -b1 * s1 - s2;
+    float dr = 1.f + a1 * c1 + a2 * c2, di = -a1 * s1 - a2 * s2;
+    return sqrtf((nr * nr + ni * ni) / (dr * dr + di * di));
+}
+
+void noise_level_init(uint32_t sample_rate) {
+    rate = sample_rate;
+
+    float p1 = bilinear_pole(POLE_F1);
+    float p4 = bilinear_pole(POLE_F4);
+    set_stage(&stages[0], p1, p1, -1);
+    set_stage(&stages[1], bilinear_pole(POLE_F2), bilinear_pole(POLE_F3), -1);
+    set_stage(&stages[2], p4, p4, +1);
+
+    float g = 1.f;
+    for (uint i = 0; i < 3; ++i)
+        g *= stage_gain(&stages[i], 1000.f);
+    gain_q28 = (int32_t)lroundf((1 << COEFF_SHIFT) / g);
+
+    // Menor potência de 2 que cobre a constante de tempo Fast.
+    fast_shift = 0;
+    while ((1u << fast_shift) < rate * NOISE_FAST_MS / 1000)
+        ++fast_shift;
+    fast_acc = 0;
+    warmup = WARMUP_FAST << fast_shift;
+
+    interval_count = 0;
+}
+
+int noise_level_add_interval(uint32_t interval_ms) {
+    if (interval_count >= NOISE_MAX_INTERVALS)
+        return -1;
+
+    interval_t *iv = &intervals[interval_count];
+    iv->length = (uint64_t)rate * interval_ms / 1000;
+    iv->count = 0;
+    iv->sum = 0;
+    iv->max = 0;
+    iv->min = UINT64_MAX;
+    iv->result.interval_ms = interval_ms;
+    iv->pending = false;
+    return interval_count++;
+}
+
+static inline int32_t run_stage(biquad_t *s, int32_t x) {
+    int64_t acc = (int64_t)(x + 2 * s->zero_sign * s->x1 + s->x2) << COEFF_SHIFT;
+    acc -= (int64_t)s->a1 * s->y1 + (int64_t)s->a2 * s->y2;
+    int32_t y = (int32_t)((acc + (1 << (COEFF_SHIFT - 1))) >> COEFF_SHIFT);
+
+    s->x2 = s->x1;
+    s->x1 = x;
+    s->y2 = s->y1;
+    s->y1 = y;
+    return y;
+}
+
+static float to_db(uint64_t energy, uint32_t count) {
+    if (energy == 0)
+        return -120.f + NOISE_CAL_DB; // Silêncio digital
+    return 10.f * log10f((float)energy / count / full_scale_energy) + NOISE_CAL_DB;
+}
+
+/**
+ * Fecha um intervalo: converte as somas em dB e recomeça.
+ */
+static void close_interval(interval_t *iv) {
+    iv->result.leq_db = to_db(iv->sum, iv->count);
+    iv->result.lmax_db = to_db(iv->max, 1u << fast_shift);
+    iv->result.lmin_db = to_db(iv->min, 1u << fast_shift);
+    iv->pending = true;
+
+    iv->count = 0;
+    iv->sum = 0;
+    iv->max = 0;
+    iv->min = UINT64_MAX;
+}
+
+static inline void track_fast(interval_t *iv) {
+    if (fast_acc > iv->max) iv->max = fast_acc;
+    if (fast_acc < iv->min) iv->min = fast_acc;
+}
+
+void noise_level_feed(const adc_sample_t *samples, uint count) {
+    for (uint n = 0; n < count; ++n) {
+        int32_t x = ((int32_t)samples[n] - (int32_t)ADC_SAMPLE_MID) << INPUT_SHIFT;
+        for (uint i = 0; i < 3; ++i)
+            x = run_stage(&stages[i], x);
+        int32_t y = (int32_t)(((int64_t)x * gain_q28) >> COEFF_SHIFT);
+
+        uint64_t energy = (int64_t)y * y;
+        fast_acc += energy - (fast_acc >> fast_shift);
+
+        if (warmup > 0) {
+            --warmup;
+            continue;
+        }
+
+        for (uint i = 0; i < interval_count; ++i) {
+            interval_t *iv = &intervals[i];
+            iv->sum += energy;
+            if (++iv->count == iv->length) {
+                // O bloco que fecha o intervalo ainda é dele.
+                track_fast(iv);
+                close_interval(iv);
+            }
+        }
+    }
+
+    if (warmup > 0)
+        return;
+
+    // Lmax e Lmin amostrados a cada bloco (4 ms), bem abaixo dos 125 ms do Fast.
+    // Intervalo que acabou de fechar na última amostra ainda não tem nada seu.
+    for (uint i = 0; i < interval_count; ++i) {
+        if (intervals[i].count > 0)
+            track_fast(&intervals[i]);
+    }
+}
+
+bool noise_level_poll(uint index, noise_level_t *result) {
+    if (index >= interval_count || !intervals[index].pending)
+        return false;
+
+    *result = intervals[index].result;
+    intervals[index].pending = false;
+    return true;
+}
@@ -0,0 +1,77 @@
+/**
+ * @file onset_detector.c
+ * @brief Implementação do detector de batidas por energia
+ */
+
+#include "onset_detector.h"
+
+#define DC_SHIFT 10 // Constante de tempo do nível DC: 1024 amostras
+
+static uint32_t rate;
+static uint32_t dc_acc;       // Nível DC em ponto fixo (<< DC_SHIFT)
+static uint32_t frame_sum;    // Soma dos quadrados do quadro atual
+static uint frame_count;      // Amostras acumuladas no quadro atual
+static uint32_t energy_avg;   // Média lenta da energia dos quadros
+static uint warmup;           // Quadros restantes até a média estabilizar
+static uint refractory;       // Quadros restantes sem detecção
+static uint refractory_frames;
+
+static bool pending;
+static onset_event_t last_event;
+
+void onset_detector_init(uint32_t sample_rate) {
+    rate = sample_rate;
+    dc_acc = ADC_SAMPLE_MID << DC_SHIFT;
+    frame_sum = 0;
+    frame_count = 0;
+    energy_avg = 0;
+    warmup = 1u << ONSET_AVG_SHIFT;
+    refractory = 0;
+    refractory_frames = sample_rate * ONSET_REFRACTORY_MS / 1000 / ONSET_HOP;
+    pending = false;
+}
+
+/**
+ * Fecha um quadro: compara a energia com a média e atualiza a média.
+ */
+static void close_frame(uint64_t time_us) {
+    uint32_t energy = frame_sum / ONSET_HOP;
+
+    if (refractory > 0) {
+        --refractory;
+    } else if (warmup == 0 && energy > ADC_ENERGY(ONSET_FLOOR) &&
+               (uint64_t)energy * 16 > (uint64_t)energy_avg * ONSET_RATIO_Q4) {
+        uint32_t ratio = energy_avg ? (uint64_t)energy * 16 / energy_avg : 0xFFFF;
+        last_event.time_us = time_us;
+        last_event.strength = ratio > 0xFFFF ? 0xFFFF : ratio;
+        pending = true;
+        refractory = refractory_frames;
+    }
+
+    if (warmup > 0) --warmup;
+    energy_avg += ((int32_t)energy - (int32_t)energy_avg) >> ONSET_AVG_SHIFT;
+
+    frame_sum = 0;
+    frame_count = 0;
+}
+
+void onset_detector_feed(const adc_sample_t *samples, uint count, uint64_t end_time_us) {
+    for (uint i = 0; i < count; ++i) {
+        int32_t dc = dc_acc >> DC_SHIFT;
+        int32_t dev = (int32_t)samples[i] - dc;
+        dc_acc += samples[i] - dc;
+
+        frame_sum += (uint32_t)(dev * dev);
+        if (++frame_count == ONSET_HOP)
+            close_frame(end_time_us - (uint64_t)(count - 1 - i) * 1000000u / rate);
+    }
+}
+
+bool onset_detector_poll(onset_event_t *event) {
+    if (!pending)
+        return false;
+
+    *event = last_event;
+    pending = false;
+    return true;
+}
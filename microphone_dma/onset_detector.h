@@ -0,0 +1,54 @@
+/**
+ * @file onset_detector.h
+ * @brief Detector de ataques (batidas) por energia no fluxo contínuo do microfone
+ *
+ * O sinal é dividido em quadros curtos (ONSET_HOP amostras, 4 ms a 16 kHz).
+ * Para cada quadro calcula-se a energia sem o nível DC, em inteiros, e ela é
+ * comparada com a média lenta das energias anteriores: um quadro com energia
+ * ONSET_RATIO vezes acima da média, e acima do piso mínimo, é uma batida.
+ * Depois de uma batida o detector fica surdo por ONSET_REFRACTORY_MS.
+ */
+
+#ifndef ONSET_DETECTOR_H
+#define ONSET_DETECTOR_H
+
+#include "pico/stdlib.h"
+#include <stdbool.h>
+#include "adc_stream.h"
+
+#define ONSET_HOP 64               // Amostras por quadro de energia
+#define ONSET_RATIO_Q4 48          // Energia mínima em relação à média (Q4: 48/16 = 3x)
+#define ONSET_FLOOR 2500           // Energia mínima (contagens² do ADC em 12-bits) para ignorar o ruído
+#define ONSET_AVG_SHIFT 4          // Média lenta: 1/16 por quadro (~64 ms a 16 kHz)
+#define ONSET_REFRACTORY_MS 100    // Intervalo mínimo entre batidas
+
+/**
+ * @brief Batida detectada
+ */
+typedef struct {
+    uint64_t time_us;   /**< Instante do fim do quadro que disparou a batida */
+    uint16_t strength;  /**< Energia do quadro em relação à média (Q4, 16 = 1x) */
+} onset_event_t;
+
+/**
+ * @brief Prepara o detector para a taxa de amostragem do microfone
+ */
+void onset_detector_init(uint32_t sample_rate);
+
+/**
+ * @brief Entrega amostras ao detector
+ *
+ * @param samples Amostras do microfone (12-bits)
+ * @param count Quantidade de amostras (não precisa ser múltiplo de ONSET_HOP)
+ * @param end_time_us Instante da última amostra do bloco
+ */
+void onset_detector_feed(const adc_sample_t *samples, uint count, uint64_t end_time_us);
+
+/**
+ * @brief Retira a batida pendente, se houver
+ *
+ * @return true se uma batida foi detectada desde a última chamada
+ */
+bool onset_detector_poll(onset_event_t *event);
+
+#endif /* ONSET_DETECTOR_H */
@@ -0,0 +1,175 @@
+/**
+ * @file pitch_tracker.c
+ * @brief Implementação do detector de altura YIN em ponto fixo
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include "pitch_tracker.h"
+
+#define HIST_SIZE 512 // Histórico das amostras dizimadas (potência de 2, >= janela + tau máximo)
+#define FRAME_SIZE (PITCH_WINDOW + PITCH_TAU_MAX + 2)
+#define Q12_ONE 4096
+
+static uint16_t hist[HIST_SIZE];
+static uint hist_pos;
+static uint hist_filled;
+static uint hop_count;
+
+static uint32_t dec_acc;
+static uint dec_count;
+static uint32_t dec_rate;   // Taxa após a dizimação
+
+static int16_t frame[FRAME_SIZE];
+static uint32_t diff[PITCH_TAU_MAX + 2];   // d(tau)
+static uint16_t dprime[PITCH_TAU_MAX + 2]; // CMND em Q12
+
+static bool pending;
+static bool last_voiced;
+static uint32_t last_tau_q8; // Período em amostras dizimadas (Q8)
+static uint16_t last_clarity;
+
+void pitch_tracker_init(uint32_t sample_rate) {
+    dec_rate = sample_rate / PITCH_DECIMATION;
+    hist_pos = 0;
+    hist_filled = 0;
+    hop_count = 0;
+    dec_acc = 0;
+    dec_count = 0;
+    pending = false;
+}
+
+/**
+ * Diferença quadrática entre a janela e ela mesma atrasada de tau.
+ * Diferenças cabem em 13 bits, então a soma de PITCH_WINDOW termos cabe em 32 bits.
+ */
+static uint32_t difference(uint tau) {
+    uint32_t d = 0;
+    const int16_t *a = frame;
+    const int16_t *b = frame + tau;
+
+    for (uint j = 0; j < PITCH_WINDOW; ++j) {
+        int32_t delta = a[j] - b[j];
+        d += (uint32_t)(delta * delta);
+    }
+    return d;
+}
+
+/**
+ * Roda o YIN sobre as FRAME_SIZE amostras dizimadas mais recentes.
+ */
+static void analyze(void) {
+    // Copia o histórico para um quadro linear, sem o nível DC.
+    uint start = (hist_pos + HIST_SIZE - FRAME_SIZE) & (HIST_SIZE - 1);
+    int32_t sum = 0;
+    for (uint i = 0; i < FRAME_SIZE; ++i)
+        sum += hist[(start + i) & (HIST_SIZE - 1)];
+    int32_t mean = sum / FRAME_SIZE;
+
+    uint64_t energy = 0;
+    for (uint i = 0; i < FRAME_SIZE; ++i) {
+        frame[i] = (int16_t)(hist[(start + i) & (HIST_SIZE - 1)] - mean);
+        if (i < PITCH_WINDOW)
+            energy += (uint32_t)(frame[i] * frame[i]);
+    }
+
+    pending = true;
+    last_voiced = false;
+    if (energy / PITCH_WINDOW < ADC_ENERGY(PITCH_MIN_ENERGY))
+        return; // Silêncio
+
+    // Função diferença e CMND, com parada antecipada: ao achar o primeiro
+    // vale abaixo do limiar, só calculamos até ele voltar a subir.
+    uint64_t running = 0;
+    int found = -1;
+    dprime[0] = Q12_ONE;
+
+    for (uint tau = 1; tau <= PITCH_TAU_MAX + 1; ++tau) {
+        uint32_t d = difference(tau);
+        diff[tau] = d;
+        running += d;
+        uint64_t dp = running ? ((uint64_t)d * tau << 12) / running : Q12_ONE;
+        dprime[tau] = dp > 0xFFFF ? 0xFFFF : dp;
+
+        if (found < 0) {
+            if (tau >= PITCH_TAU_MIN && tau <= PITCH_TAU_MAX && dprime[tau] < PITCH_THRESHOLD_Q12)
+                found = tau;
+        } else if (dprime[tau] < dprime[found] && tau <= PITCH_TAU_MAX) {
+            found = tau; // Ainda descendo no vale
+        } else {
+            break; // d(found + 1) já calculado para a interpolação
+        }
+    }
+
+    if (found < 0)
+        return; // Sem período claro (ruído)
+
+    // Interpolação parabólica em torno do mínimo, sobre d(tau): mais precisa que
+    // sobre a CMND nos períodos curtos (notas agudas).
+    int64_t a = diff[found - 1], b = diff[found], c = diff[found + 1];
+    int64_t denom = a - 2 * b + c;
+    int32_t shift_q8 = 0;
+    if (denom > 0) {
+        shift_q8 = ((a - c) * 128) / denom;
+        if (shift_q8 > 128) shift_q8 = 128;
+        if (shift_q8 < -128) shift_q8 = -128;
+    }
+
+    last_tau_q8 = (uint32_t)found * 256 + shift_q8;
+    last_clarity = Q12_ONE - (dprime[found] > Q12_ONE ? Q12_ONE : dprime[found]);
+    last_voiced = true;
+}
+
+void pitch_tracker_feed(const adc_sample_t *samples, uint count) {
+    for (uint i = 0; i < count; ++i) {
+        dec_acc += samples[i];
+        if (++dec_count < PITCH_DECIMATION)
+            continue;
+
+        hist[hist_pos] = dec_acc / PITCH_DECIMATION;
+        hist_pos = (hist_pos + 1) & (HIST_SIZE - 1);
+        dec_acc = 0;
+        dec_count = 0;
+
+        if (hist_filled < FRAME_SIZE)
+            ++hist_filled;
+        if (++hop_count >= PITCH_HOP && hist_filled == FRAME_SIZE) {
+            hop_count = 0;
+            analyze();
+        }
+    }
+}
+
+bool pitch_tracker_poll(pitch_result_t *result) {
+    if (!pending)
+        return false;
+    pending = false;
+
+    result->voiced = last_voiced;
+    result->clarity_q12 = last_voiced ? last_clarity : 0;
+    if (!last_voiced) {
+        result->freq_hz = 0.f;
+        result->midi = 0;
+        result->cents = 0;
+        return true;
+    }
+
+    // Conversão para nota só uma vez por quadro: ponto flutuante aqui é barato.
+    result->freq_hz = dec_rate * 256.f / last_tau_q8;
+    float semitones = 69.f + 12.f * log2f(result->freq_hz / 440.f);
+    result->midi = (int)lroundf(semitones);
+    result->cents = (int)lroundf((semitones - result->midi) * 100.f);
+    return true;
+}
+
+void pitch_note_name(int midi, char *buffer, uint size) {
+    static const char *names[12] = {
+        "C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B"
+    };
+
+    if (midi <= 0) {
+        snprintf(buffer, size, "REST");
+        return;
+    }
+    snprintf(buffer, size, "%s%d", names[midi % 12], midi / 12 - 1);
+}
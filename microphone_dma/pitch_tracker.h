@@ -0,0 +1,63 @@
+/**
+ * @file pitch_tracker.h
+ * @brief Detector de altura (pitch) YIN em ponto fixo, em tempo real no microfone
+ *
+ * Versão embarcada do detector YIN que o transcribe_audio.py (aubio) usa no PC:
+ *  1. o sinal do microfone é dizimado por PITCH_DECIMATION (média de pares);
+ *  2. a cada PITCH_HOP amostras dizimadas, calcula-se a função diferença
+ *     d(tau) = soma (x[j] - x[j + tau])² sobre PITCH_WINDOW amostras, em inteiros;
+ *  3. d(tau) é normalizada pela média acumulada (CMND), em Q12;
+ *  4. o primeiro mínimo abaixo de PITCH_THRESHOLD_Q12 dá o período, refinado
+ *     por interpolação parabólica.
+ *
+ * Com 16 kHz de entrada: 8 kHz após dizimar, 25 resultados por segundo,
+ * faixa de ~80 Hz a 1 kHz.
+ */
+
+#ifndef PITCH_TRACKER_H
+#define PITCH_TRACKER_H
+
+#include "pico/stdlib.h"
+#include <stdbool.h>
+#include "adc_stream.h"
+
+#define PITCH_DECIMATION 2       // 16 kHz -> 8 kHz
+#define PITCH_WINDOW 200         // Amostras (dizimadas) somadas em d(tau): 25 ms
+#define PITCH_TAU_MIN 8          // Período mínimo: 8 kHz / 8 = 1 kHz
+#define PITCH_TAU_MAX 100        // Período máximo: 8 kHz / 100 = 80 Hz
+#define PITCH_HOP 320            // Amostras (dizimadas) entre resultados: 40 ms, 25 Hz
+#define PITCH_THRESHOLD_Q12 614  // Limiar do YIN: 0,15 em Q12
+#define PITCH_MIN_ENERGY 400     // Energia média mínima (contagens² em 12-bits) para tentar detectar
+
+/**
+ * @brief Resultado de um quadro
+ */
+typedef struct {
+    bool voiced;            /**< false em silêncio ou som sem altura definida */
+    float freq_hz;          /**< Frequência fundamental estimada */
+    int midi;               /**< Nota MIDI mais próxima (69 = Lá4) */
+    int cents;              /**< Desvio em relação à nota, de -50 a +50 */
+    uint16_t clarity_q12;   /**< 1 - d'(tau) no período escolhido (Q12, 4096 = periódico perfeito) */
+} pitch_result_t;
+
+/**
+ * @brief Prepara o detector para a taxa de amostragem do microfone
+ */
+void pitch_tracker_init(uint32_t sample_rate);
+
+/**
+ * @brief Entrega amostras do microfone; o YIN roda a cada PITCH_HOP amostras dizimadas
+ */
+void pitch_tracker_feed(const adc_sample_t *samples, uint count);
+
+/**
+ * @brief Retira o resultado do último quadro, se houver um novo
+ */
+bool pitch_tracker_poll(pitch_result_t *result);
+
+/**
+ * @brief Nome da nota MIDI no formato do transcribe_audio.py (ex.: "A4", "C#5")
+ */
+void pitch_note_name(int midi, char *buffer, uint size);
+
+#endif /* PITCH_TRACKER_H */
@@ -0,0 +1,105 @@
+/**
+ * @file self_test.c
+ * @brief Implementação do autoteste buzzer -> microfone
+ */
+
+#include <stdio.h>
+#include "self_test.h"
+#include "adc_stream.h"
+#include "goertzel.h"
+#include "hardware/pwm.h"
+#include "hardware/clocks.h"
+
+#define BUZZER_CLKDIV 40.f // Com 125 MHz, o wrap de 16-bits cobre tons a partir de ~48 Hz
+
+static const uint16_t test_tones[] = SELF_TEST_TONES;
+#define TEST_TONE_COUNT (sizeof(test_tones) / sizeof(test_tones[0]))
+
+void buzzer_init(void) {
+    gpio_set_function(BUZZER_PIN, GPIO_FUNC_PWM);
+    uint slice_num = pwm_gpio_to_slice_num(BUZZER_PIN);
+    pwm_config config = pwm_get_default_config();
+    pwm_config_set_clkdiv(&config, BUZZER_CLKDIV);
+    pwm_init(slice_num, &config, true);
+    pwm_set_gpio_level(BUZZER_PIN, 0); // Desliga o PWM inicialmente
+}
+
+void buzzer_tone(uint freq_hz) {
+    if (freq_hz == 0) {
+        pwm_set_gpio_level(BUZZER_PIN, 0);
+        return;
+    }
+
+    uint slice_num = pwm_gpio_to_slice_num(BUZZER_PIN);
+    uint32_t top = clock_get_hz(clk_sys) / (BUZZER_CLKDIV * freq_hz) - 1;
+    if (top > 0xFFFF) top = 0xFFFF;
+
+    pwm_set_wrap(slice_num, top);
+    pwm_set_gpio_level(BUZZER_PIN, top / 2); // 50% de duty cycle
+}
+
+/**
+ * Passa amostras do microfone pelo banco até completar um bloco.
+ */
+static void measure_block(uint mic_channel) {
+    adc_sample_t samples[64];
+
+    while (!goertzel_block_done()) {
+        uint n = adc_stream_read(mic_channel, samples, 64);
+        if (n == 0) {
+            tight_loop_contents();
+            continue;
+        }
+        goertzel_feed(samples, n);
+    }
+}
+
+bool self_test_run(uint mic_channel, uint32_t sample_rate) {
+    uint32_t sums[TEST_TONE_COUNT];
+    bool all_ok = true;
+
+    goertzel_init(sample_rate, SELF_TEST_BLOCK);
+    for (uint i = 0; i < TEST_TONE_COUNT; ++i)
+        goertzel_add_tone(test_tones[i]);
+
+    printf("SELFTEST: inicio %u tons\r\n", (uint)TEST_TONE_COUNT);
+
+    for (uint t = 0; t < TEST_TONE_COUNT; ++t) {
+        buzzer_tone(test_tones[t]);
+        sleep_ms(SELF_TEST_SETTLE_MS);
+
+        // Descarta o áudio anterior (transitório) e começa um bloco novo.
+        adc_sample_t discard[64];
+        while (adc_stream_read(mic_channel, discard, 64) > 0)
+            ;
+        goertzel_reset();
+
+        for (uint i = 0; i < TEST_TONE_COUNT; ++i)
+            sums[i] = 0;
+        for (uint b = 0; b < SELF_TEST_BLOCKS; ++b) {
+            measure_block(mic_channel);
+            for (uint i = 0; i < TEST_TONE_COUNT; ++i)
+                sums[i] += goertzel_power(i);
+        }
+
+        buzzer_tone(0);
+
+        uint best = 0;
+        for (uint i = 1; i < TEST_TONE_COUNT; ++i)
+            if (sums[i] > sums[best])
+                best = i;
+
+        uint power = sums[t] / SELF_TEST_BLOCKS;
+        bool ok = best == t && power >= SELF_TEST_MIN_POWER;
+        all_ok &= ok;
+
+        // Fração em porcentagem e tom mais forte ouvido.
+        printf("SELFTEST: %u Hz %s %u%% (maior: %u Hz)\r\n",
+               test_tones[t], ok ? "OK" : "FALHA", power * 100 / 256, test_tones[best]);
+
+        sleep_ms(50); // Pausa entre notas
+    }
+
+    printf("SELFTEST: %s\r\n", all_ok ? "APROVADO" : "REPROVADO");
+    return all_ok;
+}
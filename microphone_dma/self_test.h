@@ -0,0 +1,52 @@
+/**
+ * @file self_test.h
+ * @brief Autoteste da placa: o buzzer toca tons e o microfone confirma que ouviu
+ *
+ * Para cada tom da lista, o buzzer (PWM) toca a nota e o banco de Goertzel
+ * mede, no fluxo do microfone, a fração da energia naquela frequência. O tom
+ * passa se essa fração superar o limiar e for a maior entre todos os tons.
+ *
+ * O resultado é enviado pela serial em linhas com o prefixo "SELFTEST:".
+ */
+
+#ifndef SELF_TEST_H
+#define SELF_TEST_H
+
+#include "pico/stdlib.h"
+#include <stdbool.h>
+
+#define BUZZER_PIN 21            // Buzzer A da BitDogLab
+#define SELF_TEST_BLOCK 400      // Bloco do Goertzel: 25 ms, resolução de 40 Hz a 16 kHz
+#define SELF_TEST_SETTLE_MS 60   // Espera o som estabilizar antes de medir
+#define SELF_TEST_BLOCKS 4       // Blocos medidos por tom (100 ms)
+#define SELF_TEST_MIN_POWER 64   // Fração mínima da energia no tom (Q8: 64/256 = 25%)
+
+// Lá4, Dó5, Ré#5, Fá#5 e Sol#5: todas dentro de menos de uma oitava (a mais
+// aguda é 1,89x a mais grave), então nenhum harmônico de um tom (2x, 3x, ...),
+// seja da onda quadrada ou do piezo, cai em outro tom. Vizinhas a pelo menos
+// 83 Hz, duas faixas do Goertzel.
+#define SELF_TEST_TONES { 440, 523, 622, 740, 831 }
+
+/**
+ * @brief Configura o PWM do buzzer (desligado)
+ */
+void buzzer_init(void);
+
+/**
+ * @brief Toca um tom contínuo no buzzer (0 desliga)
+ */
+void buzzer_tone(uint freq_hz);
+
+/**
+ * @brief Executa o autoteste buzzer -> microfone
+ *
+ * O serviço de aquisição (adc_stream) precisa estar rodando; as amostras do
+ * microfone lidas durante o teste são consumidas por ele.
+ *
+ * @param mic_channel Canal do ADC do microfone
+ * @param sample_rate Taxa de amostragem do microfone em Hz
+ * @return true se todos os tons foram reconhecidos
+ */
+bool self_test_run(uint mic_channel, uint32_t sample_rate);
+
+#endif /* SELF_TEST_H */
@@ -0,0 +1,176 @@
+/**
+ * @file sound_classifier.c
+ * @brief Implementação das entradas mel e da rede int8 do classificador de sons
+ */
+
+#include <math.h>
+#include "sound_classifier.h"
+#include "spectrogram.h"
+#include "sound_classifier_model.h"
+
+// Quadros seguidos com a mesma classe vencendo para gerar o evento: sons
+// curtos aparecem em poucos quadros, o assobio precisa se sustentar.
+static const uint8_t confirm_frames[SOUND_CLASSES] = { 0, 3, 8, 3 };
+
+static const char *class_names[SOUND_CLASSES] = { "nenhum", "palma", "assobio", "batida" };
+
+static uint8_t band_start[CLS_BANDS + 1]; // Faixas da FFT de cada faixa mel
+static uint32_t band_floor[CLS_BANDS];    // Piso de ruído de cada faixa (log2 em Q16)
+static bool floor_ready;
+
+static int8_t features[CLS_FEATURES];     // CLS_CONTEXT linhas de CLS_BANDS, a mais nova no fim
+
+static sound_class_t run_class;
+static uint run_length;
+static uint64_t run_start_us;
+static sound_class_t active_class;        // Classe já disparada, esperando sumir
+static uint quiet_frames;
+
+static bool pending;
+static sound_event_t last_event;
+
+static float hz_to_mel(float hz) {
+    return 2595.f * log10f(1.f + hz / 700.f);
+}
+
+static float mel_to_hz(float mel) {
+    return 700.f * (powf(10.f, mel / 2595.f) - 1.f);
+}
+
+void sound_classifier_init(uint32_t sample_rate) {
+    float bin_hz = (float)sample_rate / SPEC_FFT_SIZE;
+    float low = hz_to_mel(CLS_LOW_HZ), high = hz_to_mel(sample_rate / 2.f);
+
+    // Bordas em escala mel, com ao menos uma faixa da FFT por faixa mel.
+    for (uint b = 0; b <= CLS_BANDS; ++b) {
+        uint bin = (uint)lroundf(mel_to_hz(low + (high - low) * b / CLS_BANDS) / bin_hz);
+        if (b > 0 && bin <= band_start[b - 1])
+            bin = band_start[b - 1] + 1;
+        band_start[b] = bin > SPEC_BINS ? SPEC_BINS : bin;
+    }
+
+    for (uint i = 0; i < CLS_FEATURES; ++i)
+        features[i] = 0;
+    floor_ready = false;
+    run_class = SOUND_NONE;
+    run_length = 0;
+    active_class = SOUND_NONE;
+    quiet_frames = 0;
+    pending = false;
+}
+
+/**
+ * Acrescenta a linha do quadro novo às entradas: média do log2 de cada faixa
+ * mel, acima do piso da faixa, em unidades de 0,75 dB (0 a 127).
+ */
+static void push_bands(const uint16_t *frame_log2) {
+    for (uint i = 0; i < CLS_FEATURES - CLS_BANDS; ++i)
+        features[i] = features[i + CLS_BANDS];
+    int8_t *row = features + CLS_FEATURES - CLS_BANDS;
+
+    for (uint b = 0; b < CLS_BANDS; ++b) {
+        uint32_t sum = 0;
+        for (uint k = band_start[b]; k < band_start[b + 1]; ++k)
+            sum += frame_log2[k];
+        uint32_t level = sum / (band_start[b + 1] - band_start[b]);
+
+        // Piso: cai na hora, sobe devagar.
+        uint32_t level_q16 = level << 8;
+        if (!floor_ready || level_q16 < band_floor[b])
+            band_floor[b] = level_q16;
+        else
+            band_floor[b] += (level_q16 - band_floor[b]) >> CLS_FLOOR_SHIFT;
+
+        int32_t above = ((int32_t)level - (int32_t)(band_floor[b] >> 8)) >> CLS_FEATURE_SHIFT;
+        row[b] = above < 0 ? 0 : above > 127 ? 127 : above;
+    }
+    floor_ready = true;
+}
+
+/**
+ * Rede: CLS_FEATURES entradas -> CLS_HIDDEN (ReLU, requantizada em int8) -> SOUND_CLASSES.
+ */
+static sound_class_t infer(int32_t *scores) {
+    int8_t hidden[CLS_HIDDEN];
+
+    for (uint h = 0; h < CLS_HIDDEN; ++h) {
+        int32_t acc = cls_b1[h];
+        for (uint i = 0; i < CLS_FEATURES; ++i)
+            acc += cls_w1[h][i] * features[i];
+        if (acc < 0)
+            acc = 0;
+        acc = (int32_t)(((int64_t)acc * CLS_HIDDEN_MULT) >> CLS_HIDDEN_SHIFT);
+        hidden[h] = acc > 127 ? 127 : acc;
+    }
+
+    sound_class_t best = SOUND_NONE;
+    for (uint c = 0; c < SOUND_CLASSES; ++c) {
+        int32_t acc = cls_b2[c];
+        for (uint h = 0; h < CLS_HIDDEN; ++h)
+            acc += cls_w2[c][h] * hidden[h];
+        scores[c] = acc;
+        if (acc > scores[best])
+            best = c;
+    }
+    return best;
+}
+
+/**
+ * Probabilidade (softmax) da classe vencedora, só no quadro que dispara o evento.
+ */
+static uint8_t confidence(const int32_t *scores, sound_class_t best) {
+    float sum = 0.f;
+    for (uint c = 0; c < SOUND_CLASSES; ++c)
+        sum += expf((scores[c] - scores[best]) / CLS_OUTPUT_SCALE);
+    return (uint8_t)lroundf(100.f / sum);
+}
+
+void sound_classifier_feed(const uint16_t *frame_log2, uint64_t time_us) {
+    push_bands(frame_log2);
+
+    int32_t scores[SOUND_CLASSES];
+    sound_class_t best = infer(scores);
+
+    if (best == run_class) {
+        ++run_length;
+    } else {
+        run_class = best;
+        run_length = 1;
+        run_start_us = time_us;
+    }
+
+    // A classe disparada só é rearmada depois de sumir por alguns quadros.
+    if (active_class != SOUND_NONE) {
+        if (best == active_class)
+            quiet_frames = 0;
+        else if (++quiet_frames >= CLS_RELEASE_FRAMES)
+            active_class = SOUND_NONE;
+    }
+
+    if (best != SOUND_NONE && best != active_class && run_length >= confirm_frames[best]) {
+        last_event.id = best;
+        last_event.time_us = run_start_us;
+        last_event.confidence = confidence(scores, best);
+        pending = true;
+        active_class = best;
+        quiet_frames = 0;
+    }
+}
+
+bool sound_classifier_poll(sound_event_t *event) {
+    if (!pending)
+        return false;
+
+    *event = last_event;
+    pending = false;
+    return true;
+}
+
+void sound_classifier_features(int8_t *out) {
+    for (uint i = 0; i < CLS_FEATURES; ++i)
+        out[i] = features[i];
+}
+
+const char *sound_class_name(sound_class_t id) {
+    return id < SOUND_CLASSES ? class_names[id] : "?";
+}
@@ -0,0 +1,86 @@
+/**
+ * @file sound_classifier.h
+ * @brief Classificador de eventos sonoros (palma, assobio, batida na porta) no microfone
+ *
+ * Usa os quadros do espectrograma (log2 da potência a cada 12,5 ms): as faixas
+ * da FFT são agrupadas em CLS_BANDS faixas em escala mel, e cada uma é medida
+ * em relação ao seu próprio piso de ruído. As CLS_CONTEXT últimas linhas de
+ * faixas (75 ms) formam as entradas de uma rede pequena em int8 (uma camada
+ * oculta com ReLU), com os pesos em sound_classifier_model.h.
+ *
+ * A saída não é um nível contínuo: um evento com a classe reconhecida é
+ * gerado quando ela vence por alguns quadros seguidos, e a mesma classe só
+ * volta a disparar depois de alguns quadros sem ela. Tudo em inteiros; o
+ * custo por quadro é de CLS_HIDDEN * (CLS_FEATURES + SOUND_CLASSES)
+ * multiplicações, cerca de 1,1 mil com o modelo atual.
+ *
+ * Os pesos são treinados no PC com test/train_classifier.py.
+ */
+
+#ifndef SOUND_CLASSIFIER_H
+#define SOUND_CLASSIFIER_H
+
+#include "pico/stdlib.h"
+#include <stdbool.h>
+
+#define CLS_BANDS 12              // Faixas mel entre CLS_LOW_HZ e a metade da taxa
+#define CLS_LOW_HZ 100
+#define CLS_CONTEXT 6             // Quadros vistos pela rede (75 ms)
+#define CLS_FEATURES (CLS_BANDS * CLS_CONTEXT)
+#define CLS_FLOOR_SHIFT 9         // Subida do piso de cada faixa: 1/512 por quadro (~6 s)
+#define CLS_FEATURE_SHIFT 6       // Unidade das entradas: 64 em log2 Q8 (0,75 dB)
+#define CLS_RELEASE_FRAMES 4      // Quadros sem a classe para ela poder disparar de novo
+
+/**
+ * @brief Classes reconhecidas (a ordem é a das saídas da rede)
+ */
+typedef enum {
+    SOUND_NONE = 0,
+    SOUND_CLAP,
+    SOUND_WHISTLE,
+    SOUND_KNOCK,
+    SOUND_CLASSES
+} sound_class_t;
+
+/**
+ * @brief Evento reconhecido
+ */
+typedef struct {
+    sound_class_t id;
+    uint64_t time_us;    /**< Fim do primeiro quadro em que a classe venceu */
+    uint8_t confidence;  /**< Probabilidade da classe no quadro que disparou (0 a 100) */
+} sound_event_t;
+
+/**
+ * @brief Prepara as faixas mel e zera o histórico
+ *
+ * @param sample_rate Taxa do microfone (a mesma do espectrograma)
+ */
+void sound_classifier_init(uint32_t sample_rate);
+
+/**
+ * @brief Classifica um quadro do espectrograma (spectrogram_new_frame)
+ *
+ * @param frame_log2 log2 da potência (Q8) de cada faixa da FFT
+ * @param time_us Instante do fim do quadro
+ */
+void sound_classifier_feed(const uint16_t *frame_log2, uint64_t time_us);
+
+/**
+ * @brief Retira o evento pendente, se houver
+ */
+bool sound_classifier_poll(sound_event_t *event);
+
+/**
+ * @brief Entradas da rede no último quadro (CLS_FEATURES valores, do quadro mais antigo ao mais novo)
+ *
+ * Usada no PC para gerar os dados de treino com o mesmo código do firmware.
+ */
+void sound_classifier_features(int8_t *features);
+
+/**
+ * @brief Nome curto da classe, usado nas linhas enviadas pela serial
+ */
+const char *sound_class_name(sound_class_t id);
+
+#endif /* SOUND_CLASSIFIER_H */
@@ -0,0 +1,49 @@
+/**
+ * @file sound_classifier_model.h
+ * @brief Pesos int8 do classificador de sons (gerado por test/train_classifier.py, não edite)
+ *
+ * Treino: 400 clipes sintéticos de 4 s (semente 1).
+ * Validação (int8, outros clipes): acerto por quadro nenhum 100%, palma 97%, assobio 88%, batida 89%;
+ * eventos: 101 reconhecidos, 10 perdidos, 8 falsos.
+ */
+
+#ifndef SOUND_CLASSIFIER_MODEL_H
+#define SOUND_CLASSIFIER_MODEL_H
+
+#if CLS_FEATURES != 72
+#error "Modelo treinado para outras entradas: rode test/train_classifier.py"
+#endif
+
+#define CLS_HIDDEN 15
+#define CLS_HIDDEN_MULT 310
+#define CLS_HIDDEN_SHIFT 16
+#define CLS_OUTPUT_SCALE 1693.869f // Saída inteira por unidade de logit
+
+static const int8_t cls_w1[CLS_HIDDEN][CLS_FEATURES] = {
+    { 27, -42, -81, 44, 5, -37, 27, 28, 10, 29, -2, -15, 7, -65, -87, 45, 23, -19, 31, 37, 8, 30, -13, -27, -15, -90, -89, 51, 38, -8, 42, 32, 19, 27, -15, -32, -18, -91, -104, 49, 54, -6, 45, 51, 25, 14, -22, -45, -10, -94, -99, 43, 82, 16, 46, 56, 27, 11, -23, -50, -7, -79, -83, 20, 61, -17, 36, 41, 4, 15, -14, -46 },
+    { 76, 40, 24, -23, -21, -17, -18, -7, 4, 17, 19, 28, 11, -34, 24, 21, 29, 39, 16, 13, 13, 33, 15, 15, -19, -57, 31, 35, 39, 15, 20, 25, 16, 36, 19, 31, -36, -68, 39, 32, 1, 2, -6, 19, -4, 21, 11, 12, -61, -83, 37, 32, -13, -42, -17, 7, -9, 4, 21, 18, -52, -83, 6, 14, -42, -59, -34, 1, -8, 4, 23, 30 },
+    { 12, -18, 40, -23, -32, -44, -52, -43, -19, -19, -21, -22, 23, -33, 11, -8, -31, -44, -46, -46, -32, -39, -32, -36, 25, -38, 16, 10, 4, 11, 8, 13, 3, -10, -11, -18, 6, -45, 19, 40, 36, 56, 53, 52, 20, 4, -6, -34, -3, -55, 30, 52, 70, 84, 91, 85, 50, 37, 11, -15, 19, -47, 13, -23, -17, -18, -19, -7, -12, -8, -11, -29 },
+    { -41, -34, 51, 19, -22, -13, -1, -4, -21, 2, 31, 29, -30, 5, 28, 10, -2, 16, 35, 26, 19, 19, 53, 52, 13, 25, -4, 4, 7, 28, 31, 21, 0, 4, 42, 37, 33, 27, -36, -14, -24, -21, -7, -9, -18, 5, 39, 41, 77, 98, -42, -44, -58, -64, -67, -54, -39, -11, 28, 40, 41, 84, -11, -41, -45, -93, -89, -78, -71, -32, -4, -8 },
+    { -16, -77, 35, 27, 24, 19, 20, -28, -28, -9, 26, 35, 46, -5, 34, 12, -25, -40, -7, -55, -48, -19, 28, 45, 56, 1, 43, 7, -49, -51, -16, -55, -44, -17, 38, 59, 63, 21, 41, 12, -49, -50, -21, -55, -44, -6, 42, 66, 72, 36, 38, 16, -42, -46, -28, -54, -42, -3, 43, 69, 24, -12, 11, 7, -23, -55, -34, -50, -40, -6, 20, 45 },
+    { 15, -19, 32, -55, -51, 44, 31, 92, 50, -36, -35, -58, -2, 11, 1, -85, -58, 44, 24, 100, 61, -39, -44, -51, -10, 9, -8, -94, -62, 49, 17, 94, 53, -43, -35, -52, -9, -6, -19, -98, -81, 55, 33, 108, 69, -31, -36, -46, 14, 41, -34, -104, -100, 52, 12, 95, 68, -29, -29, -47, 6, 11, -40, -99, -90, 76, 30, 95, 62, -42, -52, -81 },
+    { -67, -127, 16, 73, 76, 105, -27, 37, 20, -9, -14, -19, 24, -18, 13, 21, -8, 5, -75, 9, 25, 1, -4, 15, 45, 7, 11, 24, -19, -9, -82, 14, 38, 16, 15, 22, 56, 21, -3, 20, -5, -30, -92, 18, 68, 34, 26, 48, 80, 55, -31, 13, -3, -23, -113, 5, 55, 31, 9, 36, 16, -18, -52, 47, 42, 23, -89, 12, 50, 13, -30, -16 },
+    { 82, 79, -29, -3, 18, 20, 48, 30, 51, 44, 44, 57, 8, -18, -18, -18, -9, -6, -15, -41, -40, -20, -26, -34, -14, -18, 7, 6, -9, 8, 2, -49, -33, -27, -28, -25, -27, -32, 28, 0, -10, 0, 4, -40, -37, -28, -27, -25, -48, -59, 27, -14, -44, -11, -11, -53, -57, -46, -39, -32, 27, 1, 62, 31, 2, 38, 53, 39, 29, 34, 38, 62 },
+    { 60, 52, -48, 15, 42, 34, 41, 68, 56, -18, -6, -1, 18, 1, -41, -28, 3, -22, -21, -6, -37, -83, -71, -84, 11, 8, -4, 18, 19, -10, -8, -29, -18, -75, -62, -68, -1, -15, 11, 9, 21, -8, 1, -29, -22, -75, -64, -72, -15, -52, 3, -16, -42, -16, -21, -35, -33, -102, -77, -62, 18, -6, 19, 27, 35, 64, 69, 64, 39, -33, -37, -16 },
+    { -24, -24, 28, 1, -9, -8, -2, -17, -18, -1, 6, 3, -16, -2, 19, 10, 9, 19, 21, 8, 7, 14, 19, 20, -14, 1, 9, 2, 14, 23, 22, 8, -5, 3, 12, 10, 0, 9, -1, -10, 1, -1, 0, -8, -16, 1, 6, 10, 18, 41, -4, -21, -17, -31, -31, -29, -28, -5, 8, 12, 3, 31, 5, -24, -23, -51, -49, -43, -38, -15, -5, -7 },
+    { 32, 91, -28, -20, -27, -19, -22, 24, 28, 13, -20, -28, -25, 13, -30, 3, 26, 45, 16, 54, 50, 22, -22, -40, -31, -10, -34, 7, 52, 54, 24, 52, 42, 20, -33, -53, -40, -13, -33, 6, 47, 56, 20, 51, 34, 5, -40, -65, -55, -29, -31, -8, 40, 51, 30, 51, 35, 0, -41, -66, -5, 13, -13, -5, 21, 50, 32, 45, 35, 6, -17, -40 },
+    { 10, 55, -40, -12, -1, -14, -23, 8, 22, 26, 7, 6, -12, -16, -33, 8, 23, 15, -27, -6, 8, 19, -16, -30, -31, -49, -23, 25, 37, 24, -11, 15, 15, 18, -19, -21, -52, -50, -5, 39, 49, 57, 11, 35, 12, 14, -18, -35, -82, -106, 2, 50, 44, 59, 34, 42, 21, 8, -12, -32, -60, -85, -26, 38, 18, 52, 31, 49, 34, 25, 19, 13 },
+    { 37, 58, -1, -34, -70, -70, -61, -43, -19, -8, -12, -12, 4, 5, -4, 8, -7, 2, -1, 9, 5, 9, 5, -7, 4, -1, -11, 18, 23, 27, 27, 28, 10, 13, -3, -19, 0, 1, -10, 24, 16, 35, 28, 35, -2, 1, -9, -35, -14, -23, 11, 29, 35, 36, 40, 45, 16, 17, 2, -23, 11, 15, 11, -19, -33, -34, -27, -8, -15, -3, 5, -11 },
+    { 57, 73, -14, -53, -18, -41, -11, -36, -12, -3, -15, -9, -10, -13, 32, -15, 15, -16, -5, -63, -78, -58, -55, -69, 1, -10, 41, -3, -6, -12, -18, -61, -55, -50, -47, -54, 6, -8, 58, 2, -26, -13, -19, -57, -69, -56, -54, -68, -13, -54, 75, -5, -36, -27, -23, -39, -58, -49, -40, -53, 51, 27, 110, -8, -39, -50, -14, -7, -4, 35, 28, 37 },
+    { 1, -15, -53, -26, -11, -10, -24, -6, 7, 28, 58, 72, 32, 17, -46, -51, -49, -56, -43, -12, 7, 38, 75, 96, 21, 20, -33, -55, -67, -68, -57, -6, 23, 56, 94, 117, 8, 13, -39, -55, -75, -65, -53, -18, 17, 55, 92, 119, 8, 10, -36, -44, -78, -61, -45, -22, 8, 44, 79, 106, 8, -1, -48, -20, -55, -47, -35, -15, 4, 31, 59, 90 },
+};
+static const int32_t cls_b1[CLS_HIDDEN] = { 1763, 7311, -2726, 4090, 6913, 3150, -698, 5198, 7774, 2533, 2348, 10943, -1043, 3549, 11671 };
+
+static const int8_t cls_w2[SOUND_CLASSES][CLS_HIDDEN] = {
+    { -108, 53, 25, -7, 40, -127, -58, 68, 33, -3, -39, 13, 10, 104, 72 },
+    { 45, 14, 55, 36, -54, 23, -62, -44, -82, 22, 45, 27, 49, -16, -77 },
+    { 74, -23, -81, -98, -66, 119, 66, 19, 86, -43, 54, 29, -25, -47, -98 },
+    { -7, -66, -12, 51, 53, -9, 54, -51, -40, 23, -63, -94, -36, -44, 63 },
+};
+static const int32_t cls_b2[SOUND_CLASSES] = { 189, -527, -440, -21 };
+
+#endif /* SOUND_CLASSIFIER_MODEL_H */
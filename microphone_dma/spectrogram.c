@@ -0,0 +1,176 @@
+/**
+ * @file spectrogram.c
+ * @brief Implementação da FFT em ponto fixo e do envio das colunas do espectrograma
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include "spectrogram.h"
+#include "log2_q8.h"
+
+#define TWIDDLE_SHIFT 15              // Fatores e janela em Q15
+// Entrada em contagens de 12-bits << 3 (até 2^14): fator Q15 vezes valor cabe
+// em 32 bits, e o multiplicador de 32 bits do M0+ faz cada produto num ciclo.
+#define INPUT_SHIFT (3 + ADC_SAMPLE_SHIFT)
+
+static int16_t window[SPEC_FFT_SIZE];
+static int16_t cos_table[SPEC_FFT_SIZE / 2];
+static int16_t sin_table[SPEC_FFT_SIZE / 2];
+
+static adc_sample_t hist[SPEC_FFT_SIZE];
+static uint hist_pos;
+static uint hist_filled;
+static uint hop_count;
+
+static int32_t re[SPEC_FFT_SIZE];
+static int32_t im[SPEC_FFT_SIZE];
+
+static uint16_t frame_log2[SPEC_BINS];
+static bool new_frame;
+static uint frame_count;
+static uint8_t column[SPEC_BINS];
+static bool pending;
+static uint8_t seq;
+static int32_t floor_q8;   // log2 (Q8) da potência que vira 0
+static int32_t range_q8;   // SPEC_DB_RANGE em log2 (Q8)
+
+void spectrogram_init(void) {
+    for (uint i = 0; i < SPEC_FFT_SIZE; ++i)
+        window[i] = (int16_t)lroundf(32767.f * 0.5f * (1.f - cosf(2.f * (float)M_PI * i / SPEC_FFT_SIZE)));
+    for (uint i = 0; i < SPEC_FFT_SIZE / 2; ++i) {
+        cos_table[i] = (int16_t)lroundf(32767.f * cosf(2.f * (float)M_PI * i / SPEC_FFT_SIZE));
+        sin_table[i] = (int16_t)lroundf(32767.f * sinf(2.f * (float)M_PI * i / SPEC_FFT_SIZE));
+    }
+
+    // 10*log10(2) = 3,0103 dB por unidade de log2.
+    range_q8 = SPEC_DB_RANGE * 256 * 10000 / 30103;
+    floor_q8 = SPEC_FULL_SCALE_Q8 - range_q8;
+
+    hist_pos = 0;
+    hist_filled = 0;
+    hop_count = 0;
+    new_frame = false;
+    frame_count = 0;
+    pending = false;
+    seq = 0;
+}
+
+/**
+ * FFT complexa radix-2 (decimação no tempo) sobre re/im, no lugar.
+ * Cada estágio divide por 2, então a saída é X[k] / N e não transborda.
+ */
+static void fft(void) {
+    // Reordena pelo índice com os bits invertidos.
+    for (uint i = 1, j = 0; i < SPEC_FFT_SIZE; ++i) {
+        uint bit = SPEC_FFT_SIZE >> 1;
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+        if (i < j) {
+            int32_t t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+
+    for (uint len = 2; len <= SPEC_FFT_SIZE; len <<= 1) {
+        uint half = len >> 1;
+        uint step = SPEC_FFT_SIZE / len;
+        for (uint start = 0; start < SPEC_FFT_SIZE; start += len) {
+            for (uint k = 0; k < half; ++k) {
+                int32_t wr = cos_table[k * step], wi = -sin_table[k * step];
+                uint a = start + k, b = a + half;
+
+                int32_t tr = (re[b] * wr - im[b] * wi) >> TWIDDLE_SHIFT;
+                int32_t ti = (re[b] * wi + im[b] * wr) >> TWIDDLE_SHIFT;
+
+                re[b] = (re[a] - tr) >> 1;
+                im[b] = (im[a] - ti) >> 1;
+                re[a] = (re[a] + tr) >> 1;
+                im[a] = (im[a] + ti) >> 1;
+            }
+        }
+    }
+}
+
+/**
+ * Calcula um quadro a partir das SPEC_FFT_SIZE amostras mais recentes e,
+ * a cada SPEC_COLUMN_FRAMES quadros, a coluna enviada.
+ */
+static void analyze(void) {
+    int32_t sum = 0;
+    for (uint i = 0; i < SPEC_FFT_SIZE; ++i)
+        sum += hist[i];
+    int32_t mean = sum / (int32_t)SPEC_FFT_SIZE; // Remove o nível DC do quadro
+
+    for (uint i = 0; i < SPEC_FFT_SIZE; ++i) {
+        int32_t x = ((int32_t)hist[(hist_pos + i) & (SPEC_FFT_SIZE - 1)] - mean) << INPUT_SHIFT;
+        re[i] = (x * window[i]) >> TWIDDLE_SHIFT;
+        im[i] = 0;
+    }
+
+    fft();
+
+    // |X/N| < 2^14: a potência cabe em 32 bits sem sinal.
+    for (uint k = 0; k < SPEC_BINS; ++k)
+        frame_log2[k] = log2_q8((uint32_t)(re[k] * re[k]) + (uint32_t)(im[k] * im[k]));
+    new_frame = true;
+
+    if (++frame_count < SPEC_COLUMN_FRAMES)
+        return;
+    frame_count = 0;
+
+    for (uint k = 0; k < SPEC_BINS; ++k) {
+        int32_t level = frame_log2[k] - floor_q8;
+        if (level <= 0)
+            column[k] = 0;
+        else
+            column[k] = level >= range_q8 ? 255 : (uint8_t)(level * 255 / range_q8);
+    }
+    pending = true;
+}
+
+void spectrogram_feed(const adc_sample_t *samples, uint count) {
+    new_frame = false;
+    for (uint i = 0; i < count; ++i) {
+        hist[hist_pos] = samples[i];
+        hist_pos = (hist_pos + 1) & (SPEC_FFT_SIZE - 1);
+        if (hist_filled < SPEC_FFT_SIZE)
+            ++hist_filled;
+
+        if (++hop_count >= SPEC_FRAME_HOP && hist_filled == SPEC_FFT_SIZE) {
+            hop_count = 0;
+            analyze();
+        }
+    }
+}
+
+const uint16_t *spectrogram_new_frame(void) {
+    return new_frame ? frame_log2 : NULL;
+}
+
+bool spectrogram_poll(uint8_t *bins) {
+    if (!pending)
+        return false;
+
+    for (uint k = 0; k < SPEC_BINS; ++k)
+        bins[k] = column[k];
+    pending = false;
+    return true;
+}
+
+void spectrogram_send(const uint8_t *bins) {
+    uint8_t header[3] = { SPEC_FRAME_TYPE, seq++, SPEC_BINS };
+    uint8_t checksum = 0;
+
+    // putchar_raw: sem a conversão de \n em \r\n do stdio, que corromperia os bytes.
+    putchar_raw(SPEC_FRAME_START);
+    for (uint i = 0; i < sizeof(header); ++i) {
+        putchar_raw(header[i]);
+        checksum += header[i];
+    }
+    for (uint k = 0; k < SPEC_BINS; ++k) {
+        putchar_raw(bins[k]);
+        checksum += bins[k];
+    }
+    putchar_raw(checksum);
+}
@@ -0,0 +1,70 @@
+/**
+ * @file spectrogram.h
+ * @brief Espectrograma contínuo do microfone: colunas de FFT quantizadas em 8 bits
+ *
+ * A cada SPEC_FRAME_HOP amostras, as SPEC_FFT_SIZE mais recentes passam por
+ * uma janela de Hann e por uma FFT radix-2 em ponto fixo. O log2 da potência
+ * de cada faixa fica disponível quadro a quadro (spectrogram_new_frame), para
+ * o classificador de sons; a cada SPEC_COLUMN_FRAMES quadros o módulo de cada
+ * faixa vira um byte em escala logarítmica: 255 no fundo de escala do ADC e 0
+ * SPEC_DB_RANGE (72) dB abaixo, ~0,28 dB por passo.
+ *
+ * As colunas são enviadas pela serial em quadros binários, misturados às
+ * linhas de texto:
+ *
+ *   STX (0x02) | 'S' | seq | n | n bytes | soma de verificação
+ *
+ * A soma é de 8 bits sobre 'S', seq, n e os n bytes. Texto nunca contém STX,
+ * então o leitor sabe onde começa um quadro e, pelo tamanho, onde termina.
+ */
+
+#ifndef SPECTROGRAM_H
+#define SPECTROGRAM_H
+
+#include "pico/stdlib.h"
+#include <stdbool.h>
+#include "adc_stream.h"
+
+#define SPEC_FFT_BITS 8
+#define SPEC_FFT_SIZE (1u << SPEC_FFT_BITS) // 256 amostras: 16 ms e faixas de 62,5 Hz a 16 kHz
+#define SPEC_BINS (SPEC_FFT_SIZE / 2)       // Faixas enviadas (0 até a metade da taxa)
+#define SPEC_FRAME_HOP 200                  // Amostras entre quadros: 12,5 ms
+#define SPEC_COLUMN_FRAMES 4                // Quadros por coluna enviada: 50 ms, 20 colunas por segundo
+#define SPEC_DB_RANGE 72                    // Faixa dinâmica nos 8 bits: potência 1 da FFT em 32 bits vira 0
+#define SPEC_FULL_SCALE_Q8 (24 << 8)        // log2 (Q8) da potência de um seno de fundo de escala
+
+#define SPEC_FRAME_START 0x02               // STX
+#define SPEC_FRAME_TYPE 'S'
+
+/**
+ * @brief Prepara a janela, os fatores da FFT e o histórico
+ */
+void spectrogram_init(void);
+
+/**
+ * @brief Entrega amostras do microfone; um quadro é calculado a cada SPEC_FRAME_HOP amostras
+ *
+ * Blocos maiores que SPEC_FRAME_HOP podem completar mais de um quadro; só o
+ * último fica em spectrogram_new_frame().
+ */
+void spectrogram_feed(const adc_sample_t *samples, uint count);
+
+/**
+ * @brief log2 da potência (Q8) das SPEC_BINS faixas do quadro calculado no último spectrogram_feed
+ *
+ * Devolve NULL se o último bloco não completou um quadro. O fundo de escala
+ * (seno de amplitude máxima) fica em SPEC_FULL_SCALE_Q8.
+ */
+const uint16_t *spectrogram_new_frame(void);
+
+/**
+ * @brief Copia a última coluna (SPEC_BINS bytes), se houver uma nova
+ */
+bool spectrogram_poll(uint8_t *bins);
+
+/**
+ * @brief Envia uma coluna pela serial como quadro binário
+ */
+void spectrogram_send(const uint8_t *bins);
+
+#endif /* SPECTROGRAM_H */
@@ -0,0 +1,211 @@
+/**
+ * @file bench_mic_dsp.c
+ * @brief Custo por bloco de cada etapa da cadeia do microfone, medido no PC
+ *
+ * Uso: bench_mic_dsp [cenário | arquivo.wav]
+ *
+ * Cada etapa recebe os mesmos blocos de MIC_HOP amostras que recebe no
+ * firmware. Os tempos servem para comparar versões do código entre si: o
+ * RP2040 (Cortex-M0+ a 125 MHz, sem FPU nem divisão em hardware) é da ordem
+ * de 50 a 100 vezes mais lento que um PC, então a coluna "% do bloco" é só
+ * uma referência para o orçamento de 4 ms por bloco.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "adc_stream.h"
+#include "mic_dsp.h"
+#include "event_recorder.h"
+#include "onset_detector.h"
+#include "pitch_tracker.h"
+#include "auto_range.h"
+#include "noise_level.h"
+#include "spectrogram.h"
+#include "sound_classifier.h"
+#include "sim_stream.h"
+#include "signals.h"
+
+#define BENCH_SECONDS 20   // Áudio processado por rodada
+#define BENCH_ROUNDS 5     // Vale a melhor rodada (menos interferência do sistema)
+
+typedef enum {
+    STAGE_RECORDER,
+    STAGE_ONSET,
+    STAGE_PITCH,
+    STAGE_AUTO_RANGE,
+    STAGE_NOISE_LEVEL,
+    STAGE_SPECTROGRAM,
+    STAGE_CLASSIFIER,
+    STAGE_METER,
+    STAGE_SAMPLE_MIC,
+    STAGE_COUNT
+} stage_t;
+
+static const char *stage_names[STAGE_COUNT] = {
+    "event_recorder_feed", "onset_detector_feed", "pitch_tracker_feed",
+    "auto_range_feed", "noise_level_feed", "spectrogram_feed", "spectrogram+classifier", "mic_power+intensity", "sample_mic (total)" // Inclui a entrega simulada
+};
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static adc_sample_t *audio;
+static uint hops;
+
+/**
+ * Passa todos os blocos por uma etapa e devolve o tempo total e o pior bloco.
+ */
+static void run_stage(stage_t stage, uint64_t *total_ns, uint64_t *worst_ns) {
+    uint64_t total = 0, worst = 0;
+    volatile float sink = 0.f;
+
+    if (stage == STAGE_SAMPLE_MIC) {
+        // A cadeia inteira, com o fluxo simulado entregando os blocos.
+        adc_stream_init(ADC_CLOCK_HZ / MIC_SAMPLE_RATE - 1.f);
+        mic_dsp_init();
+        adc_stream_start();
+    } else {
+        event_recorder_init(MIC_SAMPLE_RATE, REC_PRE_MS, REC_POST_MS, ADC_LEVEL(REC_THRESHOLD));
+        onset_detector_init(MIC_SAMPLE_RATE);
+        pitch_tracker_init(MIC_SAMPLE_RATE);
+        auto_range_init();
+        noise_level_init(MIC_SAMPLE_RATE);
+        noise_level_add_interval(LEVEL_SHORT_MS);
+        spectrogram_init();
+        sound_classifier_init(MIC_SAMPLE_RATE);
+    }
+
+    for (uint h = 0; h < hops; ++h) {
+        const adc_sample_t *block = audio + (size_t)h * MIC_HOP;
+        uint64_t t0 = now_ns();
+
+        switch (stage) {
+        case STAGE_RECORDER:
+            event_recorder_feed(block, MIC_HOP);
+            if (event_recorder_ready()) {
+                // Rearma sem imprimir: o envio não faz parte do custo por bloco.
+                event_recorder_init(MIC_SAMPLE_RATE, REC_PRE_MS, REC_POST_MS, ADC_LEVEL(REC_THRESHOLD));
+            }
+            break;
+        case STAGE_ONSET: {
+            onset_event_t e;
+            onset_detector_feed(block, MIC_HOP, (uint64_t)h * 4000);
+            onset_detector_poll(&e);
+            break;
+        }
+        case STAGE_PITCH: {
+            pitch_result_t r;
+            pitch_tracker_feed(block, MIC_HOP);
+            pitch_tracker_poll(&r);
+            break;
+        }
+        case STAGE_AUTO_RANGE:
+            auto_range_feed(block, MIC_HOP);
+            break;
+        case STAGE_NOISE_LEVEL: {
+            noise_level_t r;
+            noise_level_feed(block, MIC_HOP);
+            noise_level_poll(0, &r);
+            break;
+        }
+        case STAGE_SPECTROGRAM: {
+            uint8_t r[SPEC_BINS];
+            spectrogram_feed(block, MIC_HOP);
+            spectrogram_poll(r);
+            break;
+        }
+        case STAGE_CLASSIFIER: {
+            // O classificador só roda sobre os quadros do espectrograma: a
+            // diferença para a linha anterior é o custo dele.
+            sound_event_t e;
+            spectrogram_feed(block, MIC_HOP);
+            const uint16_t *frame = spectrogram_new_frame();
+            if (frame)
+                sound_classifier_feed(frame, (uint64_t)h * 4000);
+            sound_classifier_poll(&e);
+            break;
+        }
+        case STAGE_METER:
+            sink += mic_power() + get_intensity();
+            break;
+        case STAGE_SAMPLE_MIC:
+            sample_mic();
+            if (event_recorder_ready())
+                event_recorder_init(MIC_SAMPLE_RATE, REC_PRE_MS, REC_POST_MS, ADC_LEVEL(REC_THRESHOLD));
+            break;
+        default:
+            break;
+        }
+
+        uint64_t dt = now_ns() - t0;
+        total += dt;
+        if (dt > worst)
+            worst = dt;
+    }
+
+    (void)sink;
+    *total_ns = total;
+    *worst_ns = worst;
+}
+
+static const char *source_name = "clicks";
+
+static uint16_t wav_signal(uint64_t n, uint32_t rate) {
+    (void)rate;
+    return n < (uint64_t)hops * MIC_HOP ? audio[n] << ADC_SAMPLE_SHIFT : 2048;
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1)
+        source_name = argv[1];
+
+    hops = BENCH_SECONDS * MIC_SAMPLE_RATE / MIC_HOP;
+    audio = malloc((size_t)hops * MIC_HOP * sizeof(adc_sample_t));
+
+    // Gera (ou lê) o áudio antes de medir, passando pelo próprio fluxo simulado.
+    const signal_scenario_t *scenario = signal_find(source_name);
+    if (scenario) {
+        sim_stream_set_signal(scenario->signal);
+    } else if (!sim_stream_load_wav(source_name)) {
+        fprintf(stderr, "cenário ou WAV inválido: %s\n", source_name);
+        return 2;
+    }
+    adc_stream_init(ADC_CLOCK_HZ / MIC_SAMPLE_RATE - 1.f);
+    static adc_sample_t ring[1024];
+    adc_stream_add_channel(MIC_CHANNEL, ring, 1024, 1);
+    adc_stream_start();
+    for (uint h = 0; h < hops; ++h) {
+        while (adc_stream_available(MIC_CHANNEL) < MIC_HOP)
+            tight_loop_contents();
+        adc_stream_read(MIC_CHANNEL, audio + (size_t)h * MIC_HOP, MIC_HOP);
+    }
+    sim_stream_set_signal(wav_signal); // O total reutiliza o mesmo áudio
+
+    printf("%s: %u blocos de %u amostras de %u bits (%u s a %u Hz), melhor de %u rodadas\n\n",
+           source_name, hops, MIC_HOP, ADC_SAMPLE_BITS, BENCH_SECONDS, MIC_SAMPLE_RATE, BENCH_ROUNDS);
+    printf("%-22s %12s %12s %12s\n", "etapa", "ns/bloco", "pior (ns)", "% do bloco");
+
+    double budget_ns = 1e9 * MIC_HOP / MIC_SAMPLE_RATE;
+    for (uint s = 0; s < STAGE_COUNT; ++s) {
+        uint64_t best_total = UINT64_MAX, best_worst = 0;
+        for (uint r = 0; r < BENCH_ROUNDS; ++r) {
+            uint64_t total, worst;
+            run_stage(s, &total, &worst);
+            if (total < best_total) {
+                best_total = total;
+                best_worst = worst;
+            }
+        }
+
+        double per_hop = (double)best_total / hops;
+        printf("%-22s %12.0f %12llu %11.3f%%\n", stage_names[s], per_hop,
+               (unsigned long long)best_worst, 100.0 * per_hop / budget_ns);
+    }
+
+    free(audio);
+    return 0;
+}
@@ -0,0 +1,37 @@
+# Roda um cenário do mic_dsp_run e compara a saída com a referência.
+# As linhas EVT:DATA (áudio em hexadecimal) são guardadas só como hash.
+
+execute_process(COMMAND ${RUNNER} ${SCENARIO}
+        OUTPUT_VARIABLE output
+        RESULT_VARIABLE result)
+
+string(REPLACE "\r" "" output "${output}")
+string(REGEX REPLACE "\n$" "" output "${output}")
+string(REPLACE ";" "\;" output "${output}")
+string(REPLACE "\n" ";" lines "${output}")
+
+set(normalized "")
+foreach(line IN LISTS lines)
+    if(line MATCHES "^EVT:DATA ([0-9]+) ")
+        string(MD5 hash "${line}")
+        set(line "EVT:DATA ${CMAKE_MATCH_1} md5=${hash}")
+    endif()
+    string(APPEND normalized "${line}\n")
+endforeach()
+
+if(UPDATE)
+    file(WRITE ${GOLDEN} "${normalized}")
+    message(STATUS "Referência regravada: ${GOLDEN}")
+elseif(NOT EXISTS ${GOLDEN})
+    message(FATAL_ERROR "Sem referência ${GOLDEN} (rode com -DUPDATE_GOLDEN=ON)")
+else()
+    file(READ ${GOLDEN} expected)
+    if(NOT normalized STREQUAL expected)
+        file(WRITE ${GOLDEN}.new "${normalized}")
+        message(FATAL_ERROR "Saída de ${SCENARIO} difere da referência; veja ${GOLDEN}.new")
+    endif()
+endif()
+
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "${SCENARIO}: resultado inesperado (código ${result})")
+endif()
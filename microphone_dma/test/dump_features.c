@@ -0,0 +1,70 @@
+/**
+ * @file dump_features.c
+ * @brief Imprime as entradas do classificador de sons quadro a quadro, para o treino no PC
+ *
+ * Uso: dump_features <cenário | arquivo.wav>
+ *
+ * O áudio passa pelo fluxo simulado, pelo espectrograma e pelas entradas do
+ * sound_classifier exatamente como no firmware. Cada linha traz a amostra do
+ * fim do bloco em que o quadro foi calculado e as CLS_FEATURES entradas da
+ * rede (ver test/train_classifier.py).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "adc_stream.h"
+#include "mic_dsp.h"
+#include "spectrogram.h"
+#include "sound_classifier.h"
+#include "sim_stream.h"
+#include "signals.h"
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "uso: %s <cenário | arquivo.wav>\n", argv[0]);
+        return 2;
+    }
+
+    const signal_scenario_t *scenario = signal_find(argv[1]);
+    uint64_t duration_us;
+    if (scenario) {
+        sim_stream_set_signal(scenario->signal);
+        duration_us = (uint64_t)scenario->duration_ms * 1000;
+    } else if (sim_stream_load_wav(argv[1])) {
+        duration_us = sim_stream_wav_duration_us();
+    } else {
+        fprintf(stderr, "cenário ou WAV inválido: %s\n", argv[1]);
+        return 2;
+    }
+
+    static adc_sample_t ring[1024];
+    adc_stream_init(ADC_CLOCK_HZ / MIC_SAMPLE_RATE - 1.f);
+    adc_stream_add_channel(MIC_CHANNEL, ring, 1024, 1);
+    spectrogram_init();
+    sound_classifier_init(MIC_SAMPLE_RATE);
+    adc_stream_start();
+
+    uint64_t hops = duration_us * MIC_SAMPLE_RATE / 1000000u / MIC_HOP;
+    for (uint64_t h = 0; h < hops; ++h) {
+        adc_sample_t block[MIC_HOP];
+        while (adc_stream_available(MIC_CHANNEL) < MIC_HOP)
+            tight_loop_contents();
+        adc_stream_read(MIC_CHANNEL, block, MIC_HOP);
+
+        spectrogram_feed(block, MIC_HOP);
+        const uint16_t *frame = spectrogram_new_frame();
+        if (!frame)
+            continue;
+
+        uint64_t end = (h + 1) * MIC_HOP;
+        sound_classifier_feed(frame, end * 1000000u / MIC_SAMPLE_RATE);
+
+        int8_t features[CLS_FEATURES];
+        sound_classifier_features(features);
+        printf("%llu", (unsigned long long)end);
+        for (uint i = 0; i < CLS_FEATURES; ++i)
+            printf(" %d", features[i]);
+        printf("\n");
+    }
+    return 0;
+}
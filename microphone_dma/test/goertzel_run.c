@@ -0,0 +1,104 @@
+/**
+ * @file goertzel_run.c
+ * @brief Confere no PC o banco de Goertzel com os tons do autoteste
+ *
+ * Uso: goertzel_run
+ *
+ * Repete a decisão do self_test_run() com uma onda quadrada no lugar do
+ * buzzer: cada tom de SELF_TEST_TONES tem de ser o mais forte do banco e
+ * passar de SELF_TEST_MIN_POWER. Tons vizinhos, a meio caminho entre duas
+ * notas do banco (ou uma faixa fora dele), não podem passar por nenhuma.
+ * As amostras passam pela mesma redução do FIFO que o fluxo simulado, então
+ * a cópia de 8-bits confere também a largura menor.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include "adc_stream.h"
+#include "goertzel.h"
+#include "mic_dsp.h"
+#include "self_test.h"
+#include "signals.h"
+
+#define BUZZER_AMPLITUDE 300.f // Contagens de 12-bits, um buzzer a ~20 cm da placa
+#define NOISE_AMPLITUDE 20.f
+
+static const uint16_t test_tones[] = SELF_TEST_TONES;
+#define TEST_TONE_COUNT (sizeof(test_tones) / sizeof(test_tones[0]))
+
+// Entre as notas do banco, a pelo menos 39 Hz (uma faixa) de qualquer uma.
+static const uint16_t off_tones[] = { 400, 481, 572, 681, 785, 880 };
+#define OFF_TONE_COUNT (sizeof(off_tones) / sizeof(off_tones[0]))
+
+static uint64_t sample_index;
+
+/**
+ * Entrega ms milissegundos de onda quadrada em freq_hz ao banco.
+ */
+static void play(uint freq_hz, uint ms) {
+    adc_sample_t block[64];
+    uint total = MIC_SAMPLE_RATE / 1000 * ms;
+
+    for (uint done = 0; done < total; done += 64) {
+        for (uint i = 0; i < 64; ++i, ++sample_index) {
+            float phase = fmodf((float)sample_index * freq_hz / MIC_SAMPLE_RATE, 1.f);
+            float v = (phase < .5f ? BUZZER_AMPLITUDE : -BUZZER_AMPLITUDE)
+                      + NOISE_AMPLITUDE * signal_noise(sample_index);
+            block[i] = (adc_sample_t)((2048 + lroundf(v)) >> ADC_SAMPLE_SHIFT);
+        }
+        goertzel_feed(block, 64);
+    }
+}
+
+/**
+ * Mede um tom como o self_test_run() e devolve o tom do banco aceito (-1 = nenhum).
+ */
+static int measure(uint freq_hz, uint *best_power) {
+    uint32_t sums[TEST_TONE_COUNT] = { 0 };
+
+    play(freq_hz, SELF_TEST_SETTLE_MS);
+    goertzel_reset();
+
+    for (uint b = 0; b < SELF_TEST_BLOCKS; ++b) {
+        while (!goertzel_block_done())
+            play(freq_hz, 4);
+        for (uint i = 0; i < TEST_TONE_COUNT; ++i)
+            sums[i] += goertzel_power(i);
+    }
+
+    uint best = 0;
+    for (uint i = 1; i < TEST_TONE_COUNT; ++i)
+        if (sums[i] > sums[best])
+            best = i;
+
+    *best_power = sums[best] / SELF_TEST_BLOCKS;
+    return *best_power >= SELF_TEST_MIN_POWER ? (int)best : -1;
+}
+
+int main(void) {
+    bool ok = true;
+
+    goertzel_init(MIC_SAMPLE_RATE, SELF_TEST_BLOCK);
+    for (uint i = 0; i < TEST_TONE_COUNT; ++i)
+        goertzel_add_tone(test_tones[i]);
+
+    for (uint t = 0; t < TEST_TONE_COUNT; ++t) {
+        uint power;
+        int found = measure(test_tones[t], &power);
+        bool pass = found == (int)t;
+        printf("GOERTZEL: %u Hz %s %u%%\n", test_tones[t], pass ? "OK" : "FALHA", power * 100 / 256);
+        ok &= pass;
+    }
+
+    for (uint t = 0; t < OFF_TONE_COUNT; ++t) {
+        uint power;
+        int found = measure(off_tones[t], &power);
+        printf("GOERTZEL: %u Hz %s %u%%\n", off_tones[t], found < 0 ? "rejeitado" : "ACEITO", power * 100 / 256);
+        if (found >= 0) {
+            fprintf(stderr, "%u Hz aceito como %u Hz\n", off_tones[t], test_tones[found]);
+            ok = false;
+        }
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,146 @@
+/**
+ * @file mic_dsp_run.c
+ * @brief Roda a cadeia do microfone no PC e imprime as mesmas linhas que o firmware envia pela serial
+ *
+ * Uso: mic_dsp_run <cenário | arquivo.wav> [duração_ms]
+ *
+ * O laço repete o do microphone_dma.c: consome o fluxo com sample_mic(),
+ * imprime BEAT/PITCH/SOUND/LEQ quando os analisadores têm resultado e, a cada
+ * METER_INTERVAL_US, a linha do medidor e um pedaço do evento gravado.
+ * No medidor a potência sai em contagens do ADC (mic_power), sem a conversão
+ * para Volts da placa, e cada coluna do espectrograma vira uma linha SPEC
+ * com a faixa mais forte, em vez do quadro binário. Para cenários sintéticos, o código de saída indica se
+ * as batidas, notas, eventos e sons esperados apareceram.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "adc_stream.h"
+#include "mic_dsp.h"
+#include "event_recorder.h"
+#include "onset_detector.h"
+#include "pitch_tracker.h"
+#include "noise_level.h"
+#include "spectrogram.h"
+#include "sound_classifier.h"
+#include "sim_stream.h"
+#include "signals.h"
+
+#define METER_INTERVAL_US 50000
+#define REC_LINES_PER_LOOP 8
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "uso: %s <cenário | arquivo.wav> [duração_ms]\n", argv[0]);
+        for (uint i = 0; i < signal_scenario_count; ++i)
+            fprintf(stderr, "  %s\n", signal_scenarios[i].name);
+        return 2;
+    }
+
+    const signal_scenario_t *scenario = signal_find(argv[1]);
+    uint64_t duration_us;
+    if (scenario) {
+        sim_stream_set_signal(scenario->signal);
+        duration_us = (uint64_t)scenario->duration_ms * 1000;
+    } else if (sim_stream_load_wav(argv[1])) {
+        duration_us = sim_stream_wav_duration_us();
+    } else {
+        fprintf(stderr, "cenário ou WAV inválido: %s\n", argv[1]);
+        return 2;
+    }
+    if (argc > 2)
+        duration_us = strtoull(argv[2], NULL, 10) * 1000;
+
+    adc_stream_init(ADC_CLOCK_HZ / MIC_SAMPLE_RATE - 1.f);
+    mic_dsp_init();
+    adc_stream_start();
+
+    uint64_t proximo_medidor = METER_INTERVAL_US;
+    bool nota_anterior = false;
+    int beats = 0, events = 0;
+    bool wrong_note = false, any_note = false;
+    char sounds[256] = "";
+
+    while (time_us_64() < duration_us) {
+        sample_mic();
+        uint64_t agora = time_us_64();
+
+        onset_event_t batida;
+        if (onset_detector_poll(&batida)) {
+            printf("BEAT: %llu %u\r\n", (unsigned long long)batida.time_us, batida.strength);
+            ++beats;
+        }
+
+        pitch_result_t pitch;
+        if (pitch_tracker_poll(&pitch) && (pitch.voiced || nota_anterior)) {
+            char nota[8];
+            pitch_note_name(pitch.voiced ? pitch.midi : 0, nota, sizeof(nota));
+            printf("PITCH: %s %+d %.1f %u\r\n", nota, pitch.cents, pitch.freq_hz, pitch.clarity_q12);
+            nota_anterior = pitch.voiced;
+
+            if (pitch.voiced) {
+                any_note = true;
+                if (scenario && scenario->note && strcmp(nota, scenario->note))
+                    wrong_note = true;
+            }
+        }
+
+        sound_event_t som;
+        if (sound_classifier_poll(&som)) {
+            printf("SOUND: %llu %d %s %u\r\n", (unsigned long long)som.time_us, som.id,
+                   sound_class_name(som.id), som.confidence);
+            size_t used = strlen(sounds);
+            snprintf(sounds + used, sizeof(sounds) - used, "%s%s", used ? " " : "", sound_class_name(som.id));
+        }
+
+        for (uint i = 0; i < LEVEL_INTERVALS; ++i) {
+            noise_level_t nivel;
+            if (noise_level_poll(i, &nivel))
+                printf("LEQ: %lu %.1f %.1f %.1f\r\n", (unsigned long)(nivel.interval_ms / 1000),
+                       nivel.leq_db, nivel.lmax_db, nivel.lmin_db);
+        }
+
+        uint8_t coluna[SPEC_BINS];
+        if (spectrogram_poll(coluna)) {
+            uint pico = 0;
+            for (uint k = 1; k < SPEC_BINS; ++k)
+                if (coluna[k] > coluna[pico])
+                    pico = k;
+            printf("SPEC: %u %u\r\n", pico, coluna[pico]);
+        }
+
+        if (agora >= proximo_medidor) {
+            proximo_medidor += METER_INTERVAL_US;
+            printf("%u %.2f\r\n", get_intensity(), mic_power());
+
+            if (event_recorder_ready() && event_recorder_send(REC_LINES_PER_LOOP))
+                ++events;
+        }
+    }
+
+    uint32_t overruns = adc_stream_overruns(MIC_CHANNEL);
+    printf("END: %d batidas, %d eventos, %lu perdidas\r\n", beats, events, (unsigned long)overruns);
+
+    if (!scenario)
+        return 0;
+
+    bool ok = overruns == 0;
+    if (scenario->beats >= 0 && beats != scenario->beats) {
+        fprintf(stderr, "%s: %d batidas, esperadas %d\n", scenario->name, beats, scenario->beats);
+        ok = false;
+    }
+    if (scenario->note && (wrong_note || any_note != (scenario->note[0] != '\0'))) {
+        fprintf(stderr, "%s: notas diferentes de \"%s\"\n", scenario->name, scenario->note);
+        ok = false;
+    }
+    if (scenario->events >= 0 && events != scenario->events) {
+        fprintf(stderr, "%s: %d eventos, esperados %d\n", scenario->name, events, scenario->events);
+        ok = false;
+    }
+    if (scenario->sounds && strcmp(sounds, scenario->sounds)) {
+        fprintf(stderr, "%s: sons \"%s\", esperados \"%s\"\n", scenario->name, sounds, scenario->sounds);
+        ok = false;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,153 @@
+/**
+ * @file signals.c
+ * @brief Geradores dos cenários sintéticos
+ */
+
+#include <math.h>
+#include "signals.h"
+
+#define PI_F 3.14159265f
+
+/**
+ * Ruído uniforme em [-1, 1) a partir de um hash de n (determinístico).
+ */
+static float noise(uint64_t n) {
+    uint32_t x = (uint32_t)n * 0x9E3779B1u;
+    x ^= x >> 15;
+    x *= 0x85EBCA77u;
+    x ^= x >> 13;
+    x *= 0xC2B2AE3Du;
+    x ^= x >> 16;
+    return (int32_t)x / 2147483648.f;
+}
+
+static uint16_t to_adc(float v) {
+    int32_t s = 2048 + lroundf(v);
+    return s < 0 ? 0 : s > 4095 ? 4095 : s;
+}
+
+static float seconds(uint64_t n, uint32_t rate) {
+    return (float)n / rate;
+}
+
+// Sala silenciosa: só o ruído do microfone (±3 contagens).
+static uint16_t silence(uint64_t n, uint32_t rate) {
+    (void)rate;
+    return to_adc(3.f * noise(n));
+}
+
+// Lá4 (440 Hz) entre 1 s e 3 s, com o ruído de fundo.
+static uint16_t tone440(uint64_t n, uint32_t rate) {
+    float t = seconds(n, rate);
+    float v = 3.f * noise(n);
+    if (t >= 1.f && t < 3.f)
+        v += 400.f * sinf(2.f * PI_F * 440.f * t);
+    return to_adc(v);
+}
+
+// Seis estalos genéricos (ruído branco com decaimento de ~5 ms) a cada 500 ms
+// a partir de 1 s: não são palmas, o classificador não deve disparar.
+static uint16_t clicks(uint64_t n, uint32_t rate) {
+    float t = seconds(n, rate);
+    float v = 3.f * noise(n);
+    if (t >= 1.f && t < 4.f) {
+        float since = fmodf(t - 1.f, 0.5f);
+        if (since < 0.03f)
+            v += 1500.f * expf(-since / 0.005f) * noise(n + 0x5A5A5A5Au);
+    }
+    return to_adc(v);
+}
+
+// Ruído de fundo que sobe em degraus de 12 dB a cada 1,5 s (escala automática).
+static uint16_t ramp(uint64_t n, uint32_t rate) {
+    static const float levels[] = { 3.f, 12.f, 48.f, 192.f };
+    uint step = (uint)(seconds(n, rate) / 1.5f);
+    if (step > 3)
+        step = 3;
+    return to_adc(levels[step] * noise(n));
+}
+
+/**
+ * Ruído passa-faixa em torno de `hz`: FIR de 24 coeficientes (cosseno com
+ * janela de Hann) sobre o mesmo ruído, ~1,3 kHz de largura e o mesmo desvio.
+ */
+static float band_noise(uint64_t n, uint32_t rate, float hz) {
+    float v = 0.f;
+    for (uint k = 0; k < 24; ++k) {
+        float window = 0.5f - 0.5f * cosf(2.f * PI_F * (k + 0.5f) / 24.f);
+        v += window * cosf(2.f * PI_F * hz * k / rate) * noise(n - k + 0x5A5A5A5Au);
+    }
+    return v * 0.5f;
+}
+
+// Três palmas (ruído com ressonância em 1,6 kHz e decaimento de ~6 ms) em 1 s, 1,8 s e 2,6 s.
+static uint16_t claps(uint64_t n, uint32_t rate) {
+    float t = seconds(n, rate);
+    float v = 3.f * noise(n);
+    for (uint i = 0; i < 3; ++i) {
+        float since = t - (1.f + 0.8f * i);
+        if (since >= 0.f && since < 0.06f)
+            v += 1200.f * expf(-since / 0.006f) * band_noise(n, rate, 1600.f);
+    }
+    return to_adc(v);
+}
+
+// Assobio de 1,8 kHz com vibrato de 5 Hz entre 1 s e 1,8 s.
+static uint16_t whistle(uint64_t n, uint32_t rate) {
+    float t = seconds(n, rate);
+    float v = 3.f * noise(n);
+    if (t >= 1.f && t < 1.8f) {
+        float ramp = fminf(fminf(t - 1.f, 1.8f - t) / 0.02f, 1.f);
+        float phase = 2.f * PI_F * 1800.f * t - 1800.f * 0.02f / 5.f * cosf(2.f * PI_F * 5.f * t);
+        v += 500.f * ramp * sinf(phase);
+    }
+    return to_adc(v);
+}
+
+// Duas batidas na porta (ressonâncias de 150 e 260 Hz, ~25 ms) em 1 s e 2 s.
+static uint16_t knocks(uint64_t n, uint32_t rate) {
+    float t = seconds(n, rate);
+    float v = 3.f * noise(n);
+    for (uint i = 0; i < 2; ++i) {
+        float since = t - (1.f + i);
+        if (since >= 0.f && since < 0.15f)
+            v += 900.f * expf(-since / 0.025f) *
+                 (sinf(2.f * PI_F * 150.f * since) + 0.6f * sinf(2.f * PI_F * 260.f * since));
+    }
+    return to_adc(v);
+}
+
+// Estalo de 3 ms que termina na última amostra do primeiro intervalo de 1 s
+// do medidor de nível: 8192 amostras de aquecimento (4 constantes Fast de
+// 2048) mais 16000. Cai todo no último bloco de 64 do intervalo, então o
+// Lmax desse intervalo só o vê se o bloco que fecha o intervalo contar nele.
+static uint16_t level_edge(uint64_t n, uint32_t rate) {
+    uint64_t end = 4 * 2048 + rate;
+    float v = 3.f * noise(n);
+    if (n >= end - 48 && n < end)
+        v += 1000.f * noise(n + 0x5A5A5A5Au);
+    return to_adc(v);
+}
+
+const signal_scenario_t signal_scenarios[] = {
+    { "silence", silence, 3000, 0, "", 0, "" },
+    { "tone440", tone440, 4000, -1, "A4", 0, "" },
+    { "clicks", clicks, 5000, 6, NULL, -1, "" },
+    { "ramp", ramp, 6000, -1, NULL, 0, "" },
+    { "claps", claps, 3500, 3, NULL, -1, "palma palma palma" },
+    { "whistle", whistle, 3000, -1, NULL, -1, "assobio" },
+    { "knocks", knocks, 3000, 2, NULL, -1, "batida batida" },
+    { "level_edge", level_edge, 3000, -1, NULL, -1, NULL },
+};
+const uint signal_scenario_count = sizeof(signal_scenarios) / sizeof(signal_scenarios[0]);
+
+const signal_scenario_t *signal_find(const char *name) {
+    for (uint i = 0; i < signal_scenario_count; ++i)
+        if (!strcmp(signal_scenarios[i].name, name))
+            return &signal_scenarios[i];
+    return NULL;
+}
+
+float signal_noise(uint64_t n) {
+    return noise(n);
+}
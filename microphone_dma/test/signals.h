@@ -0,0 +1,40 @@
+/**
+ * @file signals.h
+ * @brief Sinais sintéticos do microfone usados nos testes e no benchmark
+ *
+ * Cada gerador devolve a amostra n (12-bits, em torno de 2048) e pode ser
+ * chamado em qualquer ordem: o ruído vem de um hash de n, não de um estado.
+ */
+
+#ifndef SIGNALS_H
+#define SIGNALS_H
+
+#include "sim_stream.h"
+
+/**
+ * @brief Cenário de teste: gerador, duração e o que a cadeia deve encontrar nele
+ */
+typedef struct {
+    const char *name;       /**< Nome na linha de comando e no arquivo de referência */
+    sim_signal_fn signal;
+    uint32_t duration_ms;
+    int beats;              /**< Batidas esperadas (-1 = não verifica) */
+    const char *note;       /**< Única nota esperada ("" = nenhuma, NULL = não verifica) */
+    int events;             /**< Eventos gravados esperados (-1 = não verifica) */
+    const char *sounds;     /**< Sons reconhecidos esperados, em ordem ("palma palma"; NULL = não verifica) */
+} signal_scenario_t;
+
+extern const signal_scenario_t signal_scenarios[];
+extern const uint signal_scenario_count;
+
+/**
+ * @brief Ruído uniforme em [-1, 1) da amostra n, o mesmo dos cenários
+ */
+float signal_noise(uint64_t n);
+
+/**
+ * @brief Procura um cenário pelo nome
+ */
+const signal_scenario_t *signal_find(const char *name);
+
+#endif /* SIGNALS_H */
@@ -0,0 +1,235 @@
+/**
+ * @file sim_stream.c
+ * @brief Implementação do adc_stream simulado
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "adc_stream.h"
+#include "sim_stream.h"
+#include "hardware/sync.h"
+
+static float clkdiv_value;
+static uint channel_count;
+static adc_ring_t rings[ADC_STREAM_MAX_CHANNELS];
+static bool enabled[ADC_STREAM_MAX_CHANNELS];
+static bool running;
+
+static uint64_t produced;       // Amostras entregues (por canal)
+static uint64_t clock_samples;  // Relógio em períodos de amostra; anda também com o ADC parado
+static uint32_t stream_rate;
+
+static sim_signal_fn signal_fn;
+static int16_t *wav_data;
+static uint32_t wav_length;
+static uint32_t wav_rate;
+
+void sim_stream_set_signal(sim_signal_fn signal) {
+    signal_fn = signal;
+    free(wav_data);
+    wav_data = NULL;
+    wav_length = 0;
+}
+
+static uint32_t read_le(const uint8_t *p, uint bytes) {
+    uint32_t v = 0;
+    for (uint i = 0; i < bytes; ++i)
+        v |= (uint32_t)p[i] << (8 * i);
+    return v;
+}
+
+bool sim_stream_load_wav(const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (!f)
+        return false;
+
+    uint8_t header[12];
+    if (fread(header, 1, 12, f) != 12 || memcmp(header, "RIFF", 4) || memcmp(header + 8, "WAVE", 4)) {
+        fclose(f);
+        return false;
+    }
+
+    uint channels = 0, bits = 0;
+    bool ok = false;
+    uint8_t chunk[8];
+    while (fread(chunk, 1, 8, f) == 8) {
+        uint32_t size = read_le(chunk + 4, 4);
+        if (!memcmp(chunk, "fmt ", 4)) {
+            uint8_t fmt[16];
+            if (size < 16 || fread(fmt, 1, 16, f) != 16)
+                break;
+            channels = read_le(fmt + 2, 2);
+            wav_rate = read_le(fmt + 4, 4);
+            bits = read_le(fmt + 14, 2);
+            fseek(f, size - 16 + (size & 1), SEEK_CUR);
+        } else if (!memcmp(chunk, "data", 4)) {
+            if (bits != 16 || channels == 0)
+                break;
+            uint32_t frames = size / (2 * channels);
+            int16_t *raw = malloc((size_t)frames * channels * 2);
+            if (!raw)
+                break;
+            frames = fread(raw, 2 * channels, frames, f);
+
+            // Fica só com o primeiro canal.
+            free(wav_data);
+            wav_data = malloc((size_t)frames * 2);
+            for (uint32_t i = 0; i < frames; ++i)
+                wav_data[i] = raw[i * channels];
+            free(raw);
+            wav_length = frames;
+            ok = frames > 0;
+            break;
+        } else {
+            fseek(f, size + (size & 1), SEEK_CUR);
+        }
+    }
+
+    fclose(f);
+    if (ok)
+        signal_fn = NULL;
+    return ok;
+}
+
+uint64_t sim_stream_wav_duration_us(void) {
+    return wav_data ? (uint64_t)wav_length * 1000000u / wav_rate : 0;
+}
+
+void sim_stream_reset(void) {
+    produced = 0;
+    clock_samples = 0;
+    for (uint i = 0; i < ADC_STREAM_MAX_CHANNELS; ++i) {
+        rings[i].head = 0;
+        rings[i].tail = 0;
+        rings[i].overruns = 0;
+    }
+}
+
+/**
+ * Amostra n da fonte, já como leitura de 12-bits do ADC.
+ */
+static uint16_t source_sample(uint64_t n) {
+    if (signal_fn)
+        return signal_fn(n, stream_rate);
+    if (!wav_data)
+        return 2048;
+
+    // Reamostragem pelo vizinho mais próximo; 16-bits -> 12-bits em torno de 1,65 V.
+    uint64_t i = n * wav_rate / stream_rate;
+    if (i >= wav_length)
+        return 2048;
+    return 2048 + (wav_data[i] >> 4);
+}
+
+/**
+ * Equivalente à interrupção do DMA: um buffer de ADC_STREAM_BLOCK amostras por canal.
+ */
+static void deliver_block(void) {
+    for (uint i = 0; i < ADC_STREAM_BLOCK; ++i) {
+        // A fonte é sempre de 12-bits; em 8-bits o FIFO descarta os 4 bits de baixo.
+        adc_sample_t s = source_sample(produced++) >> ADC_SAMPLE_SHIFT;
+        for (uint ch = 0; ch < ADC_STREAM_MAX_CHANNELS; ++ch) {
+            if (!enabled[ch])
+                continue;
+            adc_ring_t *r = &rings[ch];
+            r->buffer[r->head & r->mask] = s;
+            if (++r->head - r->tail > r->mask + 1) {
+                ++r->tail;
+                ++r->overruns;
+            }
+        }
+    }
+}
+
+/**
+ * Espera pela próxima "interrupção": o relógio anda um buffer de DMA e, com a
+ * aquisição ligada, o buffer é entregue.
+ */
+static void next_interrupt(void) {
+    clock_samples += ADC_STREAM_BLOCK;
+    if (running)
+        deliver_block();
+}
+
+void tight_loop_contents(void) {
+    next_interrupt();
+}
+
+void __wfi(void) {
+    next_interrupt();
+}
+
+uint64_t time_us_64(void) {
+    return stream_rate ? clock_samples * 1000000u / stream_rate : 0;
+}
+
+void adc_stream_init(float clkdiv) {
+    clkdiv_value = clkdiv;
+    channel_count = 0;
+    running = false;
+    for (uint i = 0; i < ADC_STREAM_MAX_CHANNELS; ++i)
+        enabled[i] = false;
+    sim_stream_reset();
+}
+
+bool adc_stream_add_channel(uint channel, adc_sample_t *buffer, uint size, uint decimation) {
+    if (channel >= ADC_STREAM_MAX_CHANNELS || size == 0 || (size & (size - 1)) || running)
+        return false;
+
+    // Todos os canais recebem a mesma fonte; a dizimação não é simulada.
+    (void)decimation;
+    rings[channel].buffer = buffer;
+    rings[channel].mask = size - 1;
+    rings[channel].decimation = 1;
+    if (!enabled[channel])
+        ++channel_count;
+    enabled[channel] = true;
+    return true;
+}
+
+void adc_stream_start(void) {
+    stream_rate = lroundf(adc_stream_rate(0));
+    running = true;
+}
+
+void adc_stream_stop(void) {
+    running = false;
+}
+
+float adc_stream_rate(uint channel) {
+    (void)channel;
+    return ADC_CLOCK_HZ / (1.f + clkdiv_value) / (channel_count ? channel_count : 1);
+}
+
+uint adc_stream_available(uint channel) {
+    return rings[channel].head - rings[channel].tail;
+}
+
+uint adc_stream_read(uint channel, adc_sample_t *dst, uint count) {
+    adc_ring_t *r = &rings[channel];
+    uint n = r->head - r->tail;
+    if (count > n)
+        count = n;
+    for (uint i = 0; i < count; ++i)
+        dst[i] = r->buffer[(r->tail + i) & r->mask];
+    r->tail += count;
+    return count;
+}
+
+uint adc_stream_read_latest(uint channel, adc_sample_t *dst, uint count) {
+    adc_ring_t *r = &rings[channel];
+    uint n = r->head - r->tail;
+    if (n > count)
+        r->tail = r->head - count;
+    return adc_stream_read(channel, dst, count);
+}
+
+uint16_t adc_stream_latest(uint channel) {
+    adc_ring_t *r = &rings[channel];
+    return r->head ? r->buffer[(r->head - 1) & r->mask] : 0;
+}
+
+uint32_t adc_stream_overruns(uint channel) {
+    return rings[channel].overruns;
+}
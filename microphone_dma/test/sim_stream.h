@@ -0,0 +1,45 @@
+/**
+ * @file sim_stream.h
+ * @brief adc_stream simulado: entrega um sinal sintético ou um arquivo WAV como se viesse do DMA
+ *
+ * Implementa a mesma interface do adc_stream.h. A cada buffer de DMA
+ * simulado (ADC_STREAM_BLOCK amostras) o relógio avança o tempo equivalente,
+ * então tudo que depende de time_us_64() é determinístico.
+ */
+
+#ifndef SIM_STREAM_H
+#define SIM_STREAM_H
+
+#include "pico/stdlib.h"
+
+/**
+ * @brief Gera a amostra n (12-bits, 0 a 4095) do sinal simulado
+ *
+ * Em 8-bits (ADC_STREAM_8BIT) o fluxo simulado descarta os 4 bits de baixo,
+ * como o FIFO do ADC.
+ */
+typedef uint16_t (*sim_signal_fn)(uint64_t n, uint32_t sample_rate);
+
+/**
+ * @brief Usa um gerador como fonte do microfone
+ */
+void sim_stream_set_signal(sim_signal_fn signal);
+
+/**
+ * @brief Usa um WAV PCM de 16-bits como fonte (primeiro canal, reamostrado para a taxa do fluxo)
+ *
+ * @return false se o arquivo não pôde ser lido
+ */
+bool sim_stream_load_wav(const char *path);
+
+/**
+ * @brief Duração da fonte WAV carregada, em µs (0 para geradores)
+ */
+uint64_t sim_stream_wav_duration_us(void);
+
+/**
+ * @brief Volta o relógio e os buffers ao início
+ */
+void sim_stream_reset(void);
+
+#endif /* SIM_STREAM_H */
@@ -0,0 +1,21 @@
+/**
+ * @file sync.h
+ * @brief Substituto do hardware/sync.h: WFI avança o relógio simulado
+ */
+
+#ifndef HOST_HARDWARE_SYNC_H
+#define HOST_HARDWARE_SYNC_H
+
+#include "pico/stdlib.h"
+
+void __wfi(void);
+
+static inline uint32_t save_and_disable_interrupts(void) {
+    return 0;
+}
+
+static inline void restore_interrupts(uint32_t status) {
+    (void)status;
+}
+
+#endif /* HOST_HARDWARE_SYNC_H */
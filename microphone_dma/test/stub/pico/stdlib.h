@@ -0,0 +1,42 @@
+/**
+ * @file stdlib.h
+ * @brief Substituto mínimo do pico/stdlib.h para compilar a cadeia do microfone no PC
+ *
+ * O tempo é simulado: time_us_64() conta os buffers de DMA do adc_stream
+ * simulado, e esperar (tight_loop_contents() ou __wfi()) faz o relógio andar
+ * até o próximo buffer.
+ */
+
+#ifndef HOST_PICO_STDLIB_H
+#define HOST_PICO_STDLIB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+
+typedef unsigned int uint;
+
+typedef uint64_t absolute_time_t;
+typedef int32_t alarm_id_t;
+typedef int64_t (*alarm_callback_t)(alarm_id_t id, void *user_data);
+
+uint64_t time_us_64(void);
+void tight_loop_contents(void);
+
+static inline int putchar_raw(int c) {
+    return putchar(c);
+}
+
+static inline absolute_time_t from_us_since_boot(uint64_t us) {
+    return us;
+}
+
+static inline alarm_id_t add_alarm_at(absolute_time_t time, alarm_callback_t callback,
+                                      void *user_data, bool fire_if_past) {
+    (void)time; (void)callback; (void)user_data; (void)fire_if_past;
+    return 1; // O relógio simulado já acorda a cada buffer
+}
+
+#endif /* HOST_PICO_STDLIB_H */
@@ -0,0 +1,479 @@
+"""
+Treino do classificador de sons do firmware (sound_classifier.c).
+
+Gera clipes sintéticos com palmas, assobios e batidas sobre fundos variados
+(ruído, zumbido da rede, vozes e notas graves), mais estalos genéricos de
+banda larga que devem sair como "nenhum", passa cada um pelo
+dump_features (o mesmo código de entradas do firmware, compilado no PC),
+treina uma rede pequena com numpy e grava os pesos em int8 em
+sound_classifier_model.h.
+
+Uso:
+    cmake -S microphone_dma/test -B build-host && cmake --build build-host
+    python3 microphone_dma/test/train_classifier.py build-host/dump_features
+
+Com a mesma semente o resultado é sempre o mesmo. Gravações reais (WAV de
+16 kHz e 16 bits) podem entrar em build_dataset() no lugar de make_clip(),
+com a lista de eventos no mesmo formato.
+"""
+import os
+import sys
+import wave
+import argparse
+import tempfile
+import subprocess
+import numpy as np
+
+RATE = 16000
+BLOCK = 64          # MIC_HOP: dump_features marca cada quadro no fim do bloco
+FFT_SIZE = 256      # SPEC_FFT_SIZE
+FRAME_HOP = 200     # SPEC_FRAME_HOP
+CONTEXT = 6         # CLS_CONTEXT
+FEATURES = 72       # CLS_FEATURES
+HIDDEN = 16         # Neurônios ocultos no treino (CLS_HIDDEN é o que sobra depois de prune())
+CLASSES = ["nenhum", "palma", "assobio", "batida"]
+CONFIRM_FRAMES = [0, 3, 8, 3]   # Iguais a confirm_frames em sound_classifier.c
+RELEASE_FRAMES = 4              # CLS_RELEASE_FRAMES
+HIDDEN_SHIFT = 16
+
+CLIP_SECONDS = 4.0
+IGNORE = -1
+
+
+# ---------------------------------------------------------------------------
+# Síntese dos clipes (amplitudes em contagens do ADC de 12 bits)
+# ---------------------------------------------------------------------------
+
+def colored_noise(rng, n, slope):
+    """Ruído com espectro 1/f^slope (0 = branco, 1 = rosa, 2 = marrom), desvio 1."""
+    spectrum = np.fft.rfft(rng.standard_normal(n))
+    f = np.fft.rfftfreq(n, 1 / RATE)
+    f[0] = f[1]
+    noise = np.fft.irfft(spectrum / f ** (slope / 2), n)
+    return noise / (noise.std() + 1e-12)
+
+
+def resonator(x, freq, q):
+    """Filtro passa-faixa de segunda ordem (ganho 1 na ressonância)."""
+    w = 2 * np.pi * freq / RATE
+    alpha = np.sin(w) / (2 * q)
+    b0, b2 = alpha, -alpha
+    a0, a1, a2 = 1 + alpha, -2 * np.cos(w), 1 - alpha
+    y = np.zeros_like(x)
+    x1 = x2 = y1 = y2 = 0.0
+    for i, v in enumerate(x):
+        out = (b0 * v + b2 * x2 - a1 * y1 - a2 * y2) / a0
+        x2, x1 = x1, v
+        y2, y1 = y1, out
+        y[i] = out
+    return y
+
+
+def background(rng, n):
+    """Fundo do clipe: ruído do microfone mais, às vezes, ruído colorido, zumbido, voz ou nota grave."""
+    t = np.arange(n) / RATE
+    x = rng.uniform(1.5, 4) * rng.standard_normal(n)
+    kind = rng.integers(0, 5)
+    if kind == 1:
+        # Ruído colorido, às vezes com um degrau de nível (ventilador ligando, porta abrindo).
+        level = np.full(n, rng.uniform(5, 80))
+        if rng.random() < 0.5:
+            level[int(rng.uniform(0.5, CLIP_SECONDS - 0.5) * RATE):] *= rng.uniform(2, 8)
+        x += level * colored_noise(rng, n, rng.choice([0.0, 1.0, 2.0]))
+    elif kind == 2:
+        mains = rng.choice([50.0, 60.0])
+        for h in range(1, 6):
+            x += rng.uniform(2, 60) / h * np.sin(2 * np.pi * mains * h * t + rng.uniform(0, 6.3))
+    elif kind == 3:
+        # Voz: série harmônica grave com formantes e sílabas a ~4 Hz.
+        f0 = rng.uniform(90, 250) * (1 + 0.05 * np.sin(2 * np.pi * rng.uniform(0.3, 1.5) * t))
+        phase = 2 * np.pi * np.cumsum(f0) / RATE
+        formants = rng.uniform([300, 900], [800, 2200])
+        voice = np.zeros(n)
+        for h in range(1, 30):
+            fh = h * f0.mean()
+            if fh > 4000:
+                break
+            gain = sum(1 / (1 + ((fh - fm) / 150) ** 2) for fm in formants)
+            voice += gain / h ** 0.5 * np.sin(h * phase)
+        syllables = np.clip(np.sin(2 * np.pi * rng.uniform(3, 5) * t + rng.uniform(0, 6.3)), 0, None)
+        x += rng.uniform(30, 400) * voice / (np.abs(voice).max() + 1e-9) * syllables
+    elif kind == 4:
+        # Nota grave sustentada (instrumento, voz cantada): não é assobio.
+        start = rng.uniform(0, CLIP_SECONDS - 1.0)
+        length = rng.uniform(0.3, 1.5)
+        env = ((t >= start) & (t < start + length)).astype(float)
+        f = rng.uniform(120, 700)
+        tone = sum(rng.uniform(0.2, 1) / h * np.sin(2 * np.pi * f * h * t) for h in range(1, 4))
+        x += rng.uniform(50, 600) * tone * env
+    return x
+
+
+def clap(rng, n):
+    """
+    Palma: ruído com ressonância em 1-2,5 kHz, ataque instantâneo e decaimento
+    de 3-12 ms. A ressonância domina; é o que a separa de um estalo qualquer.
+    """
+    length = int(0.08 * RATE)
+    burst = rng.standard_normal(length)
+    burst = rng.uniform(0, 0.2) * burst + resonator(burst, rng.uniform(900, 2500), rng.uniform(1.5, 4.0))
+    burst *= np.exp(-np.arange(length) / (rng.uniform(0.003, 0.012) * RATE))
+    return rng.uniform(250, 1900) * burst / np.abs(burst).max()
+
+
+def knock(rng, n):
+    """Batida na porta: poucas ressonâncias graves amortecidas e um estalo fraco."""
+    length = int(0.15 * RATE)
+    t = np.arange(length) / RATE
+    x = np.zeros(length)
+    for _ in range(rng.integers(1, 4)):
+        x += rng.uniform(0.3, 1) * np.sin(2 * np.pi * rng.uniform(80, 380) * t) \
+            * np.exp(-t / rng.uniform(0.012, 0.045))
+    click = rng.standard_normal(length) * np.exp(-t / 0.002)
+    x += rng.uniform(0.05, 0.3) * click
+    return rng.uniform(250, 1600) * x / np.abs(x).max()
+
+
+def whistle(rng, n):
+    """Assobio: seno de 1-3,5 kHz com glissando e vibrato, 0,3-1,2 s, com um pouco de sopro."""
+    length = int(rng.uniform(0.3, 1.2) * RATE)
+    t = np.arange(length) / RATE
+    f0 = rng.uniform(1000, 3500)
+    f = f0 * (1 + rng.uniform(-0.3, 0.3) * t / t[-1]) * (1 + 0.02 * np.sin(2 * np.pi * 5 * t))
+    x = np.sin(2 * np.pi * np.cumsum(f) / RATE)
+    x += 0.05 * resonator(rng.standard_normal(length), f0, 4.0)
+    ramp = int(rng.uniform(0.02, 0.04) * RATE)
+    env = np.ones(length)
+    env[:ramp] = np.linspace(0, 1, ramp)
+    env[-ramp:] = np.linspace(1, 0, ramp)
+    return rng.uniform(80, 900) * x * env
+
+
+def click(rng, n):
+    """Estalo genérico (tecla, toque no microfone): ruído de espectro plano ou grave, decaimento de 2-8 ms."""
+    length = int(0.04 * RATE)
+    burst = colored_noise(rng, length, rng.choice([0.0, 0.0, 1.0, 2.0]))
+    burst *= np.exp(-np.arange(length) / (rng.uniform(0.002, 0.008) * RATE))
+    return rng.uniform(250, 1900) * burst / np.abs(burst).max()
+
+
+def make_clip(rng):
+    """
+    Um clipe: fundo mais de zero a quatro eventos espaçados. Estalos
+    genéricos entram como eventos de classe 0: os quadros deles são
+    "nenhum" e um disparo neles conta como falso. Um quarto dos
+    clipes sai em 8 bits (ADC_STREAM_8BIT), com os 4 bits de baixo zerados
+    como no FIFO do ADC. Retorna (amostras, eventos).
+    """
+    n = int(CLIP_SECONDS * RATE)
+    x = background(rng, n)
+    events = []
+    pos = int(rng.uniform(0.3, 0.8) * RATE)
+    for _ in range(rng.integers(0, 5)):
+        kind = rng.choice(4, p=[0.4, 0.2, 0.2, 0.2])
+        sound = (click, clap, whistle, knock)[kind](rng, n)
+        if pos + len(sound) >= n - int(0.2 * RATE):
+            break
+        x[pos:pos + len(sound)] += sound
+        end = pos + (len(sound) if kind == 2 else 0)
+        if kind:
+            events.append((kind, pos, end))
+        pos += len(sound) + int(rng.uniform(0.3, 0.9) * RATE)
+    if rng.random() < 0.25:
+        x = np.floor((x + 2048) / 16) * 16 - 2048
+    return x, events
+
+
+def write_wav(path, samples):
+    """Grava as contagens do ADC (em torno de 0) como WAV de 16 bits: contagem * 16."""
+    data = np.clip(np.round(samples * 16), -32768, 32767).astype('<i2')
+    with wave.open(path, 'wb') as w:
+        w.setnchannels(1)
+        w.setsampwidth(2)
+        w.setframerate(RATE)
+        w.writeframes(data.tobytes())
+
+
+# ---------------------------------------------------------------------------
+# Entradas e rótulos
+# ---------------------------------------------------------------------------
+
+def dump_features(tool, path):
+    """Roda o dump_features; retorna (fim de cada quadro em amostras, entradas)."""
+    out = subprocess.run([tool, path], check=True, capture_output=True, text=True).stdout
+    rows = np.array([line.split() for line in out.splitlines()], dtype=np.int64)
+    return rows[:, 0], rows[:, 1:].astype(np.float32)
+
+
+def label_frames(ends, events):
+    """
+    Rótulo de cada quadro. O contexto da rede cobre as amostras
+    [fim - 256 - 3*200, fim). Sons curtos valem quando o ataque está dentro
+    dos três quadros mais novos; o assobio, quando o quadro mais novo está
+    todo dentro dele. Quadros na borda de um evento ficam de fora do treino.
+    """
+    labels = np.zeros(len(ends), dtype=np.int64)
+    context = FFT_SIZE + (CONTEXT - 1) * FRAME_HOP
+    for kind, start, end in events:
+        if kind == 2:
+            inside = (ends - FFT_SIZE >= start + 320) & (ends <= end)
+            touches = (ends > start) & (ends - context < end)
+        else:
+            inside = (start >= ends - context + FFT_SIZE - BLOCK) & (start <= ends - 2 * FRAME_HOP)
+            touches = (ends > start) & (ends - context < start + int(0.05 * RATE))
+        labels[touches & (labels == 0)] = IGNORE
+        labels[inside] = kind
+    return labels
+
+
+def build_dataset(tool, clips, seed):
+    rng = np.random.default_rng(seed)
+    xs, ys, all_events, clip_frames = [], [], [], []
+    with tempfile.TemporaryDirectory() as tmp:
+        path = os.path.join(tmp, 'clip.wav')
+        for _ in range(clips):
+            samples, events = make_clip(rng)
+            write_wav(path, samples)
+            ends, features = dump_features(tool, path)
+            xs.append(features)
+            ys.append(label_frames(ends, events))
+            all_events.append(events)
+            clip_frames.append(ends)
+    return xs, ys, all_events, clip_frames
+
+
+# ---------------------------------------------------------------------------
+# Rede e quantização
+# ---------------------------------------------------------------------------
+
+def train(x, y, seed, epochs=40, batch=256, lr=3e-3):
+    """MLP FEATURES -> HIDDEN (ReLU) -> classes, com entropia cruzada ponderada e Adam."""
+    rng = np.random.default_rng(seed)
+    x = x / 127.0
+    w1 = rng.standard_normal((FEATURES, HIDDEN)) * np.sqrt(2 / FEATURES)
+    b1 = np.zeros(HIDDEN)
+    w2 = rng.standard_normal((HIDDEN, len(CLASSES))) * np.sqrt(1 / HIDDEN)
+    b2 = np.zeros(len(CLASSES))
+    params = [w1, b1, w2, b2]
+    moments = [(np.zeros_like(p), np.zeros_like(p)) for p in params]
+
+    counts = np.bincount(y, minlength=len(CLASSES))
+    class_weight = (counts.sum() / (len(CLASSES) * np.maximum(counts, 1))) ** 0.5
+    step = 0
+    for epoch in range(epochs):
+        order = rng.permutation(len(x))
+        for i in range(0, len(x), batch):
+            idx = order[i:i + batch]
+            xb, yb = x[idx], y[idx]
+            h_pre = xb @ w1 + b1
+            h = np.maximum(h_pre, 0)
+            logits = h @ w2 + b2
+            logits -= logits.max(axis=1, keepdims=True)
+            p = np.exp(logits)
+            p /= p.sum(axis=1, keepdims=True)
+
+            weight = class_weight[yb][:, None] / len(idx)
+            grad = p.copy()
+            grad[np.arange(len(idx)), yb] -= 1
+            grad *= weight
+            grads_w2 = h.T @ grad + 1e-4 * w2
+            grads_b2 = grad.sum(axis=0)
+            dh = (grad @ w2.T) * (h_pre > 0)
+            grads_w1 = xb.T @ dh + 1e-4 * w1
+            grads_b1 = dh.sum(axis=0)
+
+            step += 1
+            for p_, g, (m, v) in zip(params, [grads_w1, grads_b1, grads_w2, grads_b2], moments):
+                m *= 0.9
+                m += 0.1 * g
+                v *= 0.999
+                v += 0.001 * g * g
+                p_ -= lr * (m / (1 - 0.9 ** step)) / (np.sqrt(v / (1 - 0.999 ** step)) + 1e-8)
+    return params
+
+
+def prune(params, x):
+    """
+    Tira os neurônios ocultos que nunca ativam nos dados de treino (ReLU
+    sempre em zero): não mudam a saída e custariam CLS_FEATURES
+    multiplicações cada no firmware.
+    """
+    w1, b1, w2, b2 = params
+    alive = np.maximum(x / 127 @ w1 + b1, 0).max(axis=0) > 0
+    return [w1[:, alive], b1[alive], w2[alive], b2]
+
+
+def quantize(params, x):
+    """
+    Pesos em int8 com escala por camada. As entradas já são inteiros de 0 a
+    127 (escala 1/127 no treino); a camada oculta volta para 0-127 com
+    (acumulador * CLS_HIDDEN_MULT) >> 16, escolhido pelo maior valor visto nos dados.
+    Neurônios cujos pesos de entrada viram todos zero em int8 também saem.
+    """
+    w1, b1, w2, b2 = params
+    s1 = 127 / np.abs(w1).max()
+    alive = np.abs(np.round(w1 * s1)).max(axis=0) > 0
+    w1, b1, w2 = w1[:, alive], b1[alive], w2[alive]
+    s1 = 127 / np.abs(w1).max()                 # Pesos int8 = w1 * s1
+    acc_scale = s1 * 127                         # Acumulador = h_real * acc_scale
+    h_real = np.maximum(x / 127 @ w1 + b1, 0)
+    h_max = np.percentile(h_real.max(axis=1), 99.9)
+    hidden_scale = 127 / h_max                   # Oculta int8 = h_real * hidden_scale
+    mult = int(round(hidden_scale / acc_scale * (1 << HIDDEN_SHIFT)))
+    s2 = 127 / np.abs(w2).max()
+    q = {
+        "w1": np.round(w1.T * s1).astype(int),
+        "b1": np.round(b1 * acc_scale).astype(int),
+        "mult": mult,
+        "w2": np.round(w2.T * s2).astype(int),
+        "b2": np.round(b2 * s2 * hidden_scale).astype(int),
+        "output_scale": s2 * hidden_scale,       # Saída inteira = logit * output_scale
+    }
+    return q
+
+
+def infer_int(q, x):
+    """Mesmas contas inteiras de infer() em sound_classifier.c."""
+    acc = x.astype(np.int64) @ q["w1"].T + q["b1"]
+    acc = np.maximum(acc, 0)
+    hidden = np.minimum((acc * q["mult"]) >> HIDDEN_SHIFT, 127)
+    return hidden @ q["w2"].T + q["b2"]
+
+
+def detect_events(classes):
+    """Máquina de estados de sound_classifier_feed(): índices dos quadros e classes disparadas."""
+    events = []
+    run_class, run_length, active, quiet = 0, 0, 0, 0
+    for i, best in enumerate(classes):
+        if best == run_class:
+            run_length += 1
+        else:
+            run_class, run_length = best, 1
+        if active:
+            if best == active:
+                quiet = 0
+            else:
+                quiet += 1
+                if quiet >= RELEASE_FRAMES:
+                    active = 0
+        if best and best != active and run_length >= CONFIRM_FRAMES[best]:
+            events.append((i, int(best)))
+            active, quiet = best, 0
+    return events
+
+
+def evaluate(q, xs, ys, all_events, clip_frames):
+    """Acerto por quadro e por evento (cada evento real deve disparar uma vez, e nada mais)."""
+    confusion = np.zeros((len(CLASSES), len(CLASSES)), dtype=int)
+    hits = misses = false_alarms = 0
+    for x, y, events, ends in zip(xs, ys, all_events, clip_frames):
+        pred = infer_int(q, x).argmax(axis=1)
+        for t, p in zip(y[y >= 0], pred[y >= 0]):
+            confusion[t, p] += 1
+
+        found = [(ends[i], c) for i, c in detect_events(pred)]
+        used = [False] * len(found)
+        for kind, start, end in events:
+            limit = max(end, start) + int(0.15 * RATE)
+            match = next((j for j, (t, c) in enumerate(found)
+                          if not used[j] and c == kind and start <= t <= limit), None)
+            if match is None:
+                misses += 1
+            else:
+                used[match] = True
+                hits += 1
+        false_alarms += used.count(False)
+    return confusion, hits, misses, false_alarms
+
+
+# ---------------------------------------------------------------------------
+# Cabeçalho do firmware
+# ---------------------------------------------------------------------------
+
+def c_array(values):
+    return ', '.join(str(int(v)) for v in values)
+
+
+def write_header(path, q, summary):
+    lines = [
+        "/**",
+        " * @file sound_classifier_model.h",
+        " * @brief Pesos int8 do classificador de sons (gerado por test/train_classifier.py, não edite)",
+        " *",
+    ] + [f" * {line}" if line else " *" for line in summary] + [
+        " */",
+        "",
+        "#ifndef SOUND_CLASSIFIER_MODEL_H",
+        "#define SOUND_CLASSIFIER_MODEL_H",
+        "",
+        f"#if CLS_FEATURES != {FEATURES}",
+        "#error \"Modelo treinado para outras entradas: rode test/train_classifier.py\"",
+        "#endif",
+        "",
+        f"#define CLS_HIDDEN {len(q['w1'])}",
+        f"#define CLS_HIDDEN_MULT {q['mult']}",
+        f"#define CLS_HIDDEN_SHIFT {HIDDEN_SHIFT}",
+        f"#define CLS_OUTPUT_SCALE {q['output_scale']:.3f}f // Saída inteira por unidade de logit",
+        "",
+        "static const int8_t cls_w1[CLS_HIDDEN][CLS_FEATURES] = {",
+    ]
+    lines += [f"    {{ {c_array(row)} }}," for row in q["w1"]]
+    lines += [
+        "};",
+        f"static const int32_t cls_b1[CLS_HIDDEN] = {{ {c_array(q['b1'])} }};",
+        "",
+        "static const int8_t cls_w2[SOUND_CLASSES][CLS_HIDDEN] = {",
+    ]
+    lines += [f"    {{ {c_array(row)} }}," for row in q["w2"]]
+    lines += [
+        "};",
+        f"static const int32_t cls_b2[SOUND_CLASSES] = {{ {c_array(q['b2'])} }};",
+        "",
+        "#endif /* SOUND_CLASSIFIER_MODEL_H */",
+        "",
+    ]
+    with open(path, 'w', newline='\n') as f:
+        f.write('\n'.join(lines))
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('dump_features', help="executável dump_features do build do PC")
+    parser.add_argument('--clips', type=int, default=400, help="clipes de treino (mais 25%% para validação)")
+    parser.add_argument('--seed', type=int, default=1)
+    parser.add_argument('--output', default=os.path.join(here, '..', 'sound_classifier_model.h'))
+    args = parser.parse_args()
+
+    print(f"Gerando {args.clips} clipes de treino...")
+    xs, ys, _, _ = build_dataset(args.dump_features, args.clips, args.seed)
+    print("Gerando clipes de validação...")
+    val = build_dataset(args.dump_features, args.clips // 4, args.seed + 1000)
+
+    x = np.concatenate(xs)
+    y = np.concatenate(ys)
+    keep = y >= 0
+    print(f"Treinando com {keep.sum()} quadros: "
+          + ', '.join(f"{n} {c}" for n, c in zip(CLASSES, np.bincount(y[keep], minlength=len(CLASSES)))))
+    params = prune(train(x[keep], y[keep], args.seed), x[keep])
+    q = quantize(params, x[keep])
+
+    confusion, hits, misses, false_alarms = evaluate(q, *val)
+    recall = confusion.diagonal() / np.maximum(confusion.sum(axis=1), 1)
+    summary = [
+        f"Treino: {args.clips} clipes sintéticos de {CLIP_SECONDS:.0f} s (semente {args.seed}).",
+        "Validação (int8, outros clipes): acerto por quadro "
+        + ', '.join(f"{n} {100 * r:.0f}%" for n, r in zip(CLASSES, recall)) + ";",
+        f"eventos: {hits} reconhecidos, {misses} perdidos, {false_alarms} falsos.",
+    ]
+    print('\n'.join(summary))
+    print("Matriz de confusão (linhas: real, colunas: previsto):")
+    print(confusion)
+
+    write_header(args.output, q, summary)
+    print(f"Pesos gravados em {os.path.normpath(args.output)}")
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -1,5 +1,4 @@
-from flask import Flask, render_template, jsonify, current_app
-import serial
+from flask import Flask, render_template, jsonify, current_app, send_from_directory, request, Response
 import time
 import threading
 import queue
@@ -8,6 +7,15 @@ import logging  # Para melhor logging
 import atexit
 import os
 import sys
+import base64
+import json
+from collections import deque
+from utils.event_capture import EventAssembler
+from utils.serial_lines import parse_lines
+from utils.device_ingest import Device, DeviceIngest, load_device_config
+from utils.series_store import SeriesStore
+from utils.downsample import downsample_columns
+from utils.raw_capture import RawCapture
 
 # Configurar logging
 logging.basicConfig(level=logging.WARNING,  # Mudar de INFO para WARNING para reduzir logs no terminal
@@ -18,75 +26,162 @@ app = Flask(__name__)
 
 # Configuração
 SIMULATION_MODE = False  # Altere para True para simular dados sem usar porta serial
-SERIAL_PORT = 'COM4'
+SERIAL_PORT = 'COM4'     # Só sem devices.json: o único dispositivo é esta porta
 BAUD_RATE = 115200
+# Outro arquivo de dispositivos pode vir do ambiente (usado pelo utils/bench_http.py)
+DEVICES_FILE = os.environ.get('DEVICES_FILE', os.path.join(os.path.dirname(os.path.abspath(__file__)), 'devices.json'))
 USE_RELOADER = False  # Desabilitar o reloader para evitar problemas com a porta serial
 
-# Ativar modo de depuração detalhada
+# Ativar modo de depuração detalhada (valor inicial; muda em /api/toggle_capture)
 DEBUG_SERIAL = True
 
-# Buffer para guardar dados brutos recebidos (para diagnóstico)
-raw_buffer = []
-MAX_RAW_BUFFER = 100  # Limita quantidade de dados armazenados
+# Bytes brutos recebidos do dispositivo do painel, formatados só em /api/diagnostic
+MAX_RAW_BUFFER = 100             # Limita quantidade de leituras guardadas
+RAW_CAPTURE_BYTES = 256 * 1024   # Cabem as MAX_RAW_BUFFER leituras típicas (~2,3 KB cada)
+raw_capture = RawCapture(RAW_CAPTURE_BYTES, MAX_RAW_BUFFER, enabled=DEBUG_SERIAL)
 
-# Fila para armazenar os dados mais recentes
-data_queue = queue.Queue(maxsize=100)
+# Dispositivos lidos em paralelo (ver utils/device_ingest.py), cada um com os
+# últimos pontos do medidor em buffers circulares numéricos. O primeiro é o
+# do painel: os pontos dele alimentam /api/data, o fluxo, o espectrograma, os
+# sons, os níveis, os eventos e o armazenamento em disco; os demais ficam em
+# /api/devices/<id>/...
+HISTORY_SIZE = 100
+SMOOTHING_WINDOW = 5     # Tamanho da janela para média móvel
+devices = [Device(config, HISTORY_SIZE, SMOOTHING_WINDOW)
+           for config in load_device_config(DEVICES_FILE, [{"id": "mic", "type": "serial", "port": SERIAL_PORT}])]
+devices_by_id = {device.id: device for device in devices}
+RECORDINGS_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'recordings')
+for device in devices:
+    if device.config.get('record'):
+        device.start_recording(RECORDINGS_DIR)
+primary_device = devices[0]
+history = primary_device.history
+connection_status = primary_device.status
 latest_data = {"intensity": 0, "value": 0.0, "timestamp": time.time()}
 should_run = True
-connection_status = {"connected": False, "last_error": "Inicializando..."}
 
-# Objeto serial global para facilitar o fechamento no encerramento
-serial_instance = None
+# Navegadores conectados em /api/stream (Server-Sent Events): uma fila por cliente.
+# Cada ponto novo ganha um número de sequência, para o navegador juntar o
+# histórico do /api/data com o que chega pelo fluxo sem repetir pontos.
+STREAM_QUEUE_SIZE = 500        # Cliente lento perde o excesso e recupera pelo /api/data
+STREAM_KEEPALIVE_S = 15
+stream_clients = []
+stream_lock = threading.Lock()
+
+def publish(kind, payload):
+    """Entrega um item novo ('data', 'spectrum', ...) a todos os navegadores conectados."""
+    with stream_lock:
+        for client in stream_clients:
+            try:
+                client.put_nowait((kind, payload))
+            except queue.Full:
+                pass
+
+def store_data_point(data_point, device=None):
+    """
+    Guarda um ponto do medidor no histórico do dispositivo (o do painel, se
+    omitido); os do painel também vão para o disco e para os navegadores.
+    """
+    global latest_data
+    device = device or primary_device
+    data_point["seq"] = device.history.append(data_point["timestamp"], data_point["intensity"],
+                                              data_point["value"], data_point.get("raw_value", data_point["value"]))
+    device.latest = data_point
+    if device is not primary_device:
+        return
+    latest_data = data_point
+    series_store.append(data_point["timestamp"], data_point["intensity"],
+                        data_point["value"], data_point.get("raw_value", data_point["value"]))
+    publish("data", data_point)
 
 # Adicionar novas configurações
 LOG_DATA_POINTS = False  # Controla se os dados são logados no console
-SMOOTHING_WINDOW = 5     # Tamanho da janela para média móvel
-smoothing_buffer = []    # Buffer para suavizar valores
 
-# Configuração da porta serial
-def setup_serial():
-    global serial_instance
+# Todos os pontos do medidor ficam gravados em disco, com agregados por
+# segundo e por minuto para as consultas de períodos longos (/api/range)
+DATA_DIR = os.environ.get('DATA_DIR', os.path.join(os.path.dirname(os.path.abspath(__file__)), 'data'))
+series_store = SeriesStore(DATA_DIR)
+RANGE_RAW_MAX_S = 120        # Acima disso /api/range não devolve pontos brutos
+RANGE_1S_MAX_S = 2 * 3600    # Acima disso a resolução automática é por minuto
+
+# Eventos sonoros gravados pelo firmware (linhas "EVT:") e salvos como WAV
+EVENTS_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'events')
+event_assembler = EventAssembler(EVENTS_DIR)
+
+# Níveis com ponderação A enviados pelo firmware ("LEQ: <s> <Leq> <Lmax> <Lmin>"),
+# guardados pelo intervalo em segundos
+latest_levels = {}
+
+def parse_levels(line):
+    """Guarda uma linha LEQ do firmware em latest_levels."""
+    parts = line.split()
+    if len(parts) != 5:
+        return
+    try:
+        interval = int(parts[1])
+        latest_levels[interval] = {
+            "interval_s": interval,
+            "leq": float(parts[2]),
+            "lmax": float(parts[3]),
+            "lmin": float(parts[4]),
+            "timestamp": time.time()
+        }
+    except ValueError:
+        if LOG_DATA_POINTS:
+            logger.warning(f"Linha LEQ inválida: '{line}'")
+
+# Sons reconhecidos pelo classificador do firmware ("SOUND: <tempo_us> <id> <nome> <confiança>")
+MAX_SOUND_EVENTS = 50
+sound_events = deque(maxlen=MAX_SOUND_EVENTS)
+
+def parse_sound(line):
+    """Guarda uma linha SOUND do firmware em sound_events."""
+    parts = line.split()
+    if len(parts) != 5:
+        return
     try:
-        # Verifica se já existe uma instância aberta e fecha
-        if serial_instance:
-            try:
-                serial_instance.close()
-                logger.info("Fechando conexão serial anterior")
-            except:
-                pass
-            
-        # Tenta abrir a porta serial
-        ser = serial.Serial(SERIAL_PORT, BAUD_RATE, timeout=1)
-        serial_instance = ser
-        logger.info(f"Porta serial {SERIAL_PORT} aberta com sucesso")
-        connection_status["connected"] = True
-        connection_status["last_error"] = ""
-        return ser
-    except serial.SerialException as e:
-        error_msg = f"Erro ao abrir porta {SERIAL_PORT}: {str(e)}"
-        logger.error(error_msg)
-        connection_status["connected"] = False
-        connection_status["last_error"] = error_msg
-        return None
+        sound_events.append({
+            "device_time_us": int(parts[1]),
+            "id": int(parts[2]),
+            "name": parts[3],
+            "confidence": int(parts[4]),
+            "timestamp": time.time()
+        })
+    except ValueError:
+        if LOG_DATA_POINTS:
+            logger.warning(f"Linha SOUND inválida: '{line}'")
+
+# Colunas do espectrograma (quadros binários 'S' do firmware), numeradas na chegada
+SPEC_BIN_HZ = 16000 / 256   # Taxa do microfone / tamanho da FFT
+MAX_SPECTRUM_FRAMES = 200   # 10 s a 20 colunas por segundo
+spectrum_frames = deque(maxlen=MAX_SPECTRUM_FRAMES)
+spectrum_last_id = 0
+
+def store_spectrum(frame):
+    """Guarda uma coluna recebida; o id crescente permite ao navegador pedir só as novas."""
+    global spectrum_last_id
+    if frame.kind != 'S':
+        return
+    spectrum_last_id += 1
+    spectrum_frames.append((spectrum_last_id, frame.payload))
+    publish("spectrum", {"id": spectrum_last_id, "bins": base64.b64encode(frame.payload).decode('ascii')})
 
 # Função para limpar recursos no encerramento
 def cleanup_resources():
-    global should_run, serial_instance
+    global should_run
     logger.info("Limpando recursos...")
     should_run = False
-    if serial_instance:
-        try:
-            serial_instance.close()
-            logger.info("Porta serial fechada no encerramento")
-        except:
-            pass
+    ingest.stop()
+    for device in devices:
+        device.stop_recording()
+    series_store.close()
 
 # Registra a função de limpeza para ser chamada no encerramento
 atexit.register(cleanup_resources)
 
 def simulate_data():
-    """Gera dados simulados para testes"""
-    while should_run:
+    """Gera dados simulados para testes (para ao desativar a simulação)"""
+    while should_run and SIMULATION_MODE:
         # Simula um valor entre 0 e 3.3V com intensidade de 0 a 5
         value = random.uniform(0, 3.3)
         intensity = min(5, int(value * 1.5))  # Escala para 0-5
@@ -98,194 +193,94 @@ def simulate_data():
         }
         
         logger.debug(f"Dados simulados: {data_point}")
-        global latest_data
-        latest_data = data_point
-        
-        # Adiciona à fila, remove o mais antigo se estiver cheia
-        if data_queue.full():
-            data_queue.get()
-        data_queue.put(data_point)
+        store_data_point(data_point)
         
         time.sleep(0.2)  # Simula uma atualização a cada 200ms
 
-# Thread para ler os dados da porta serial
-def read_serial_data():
-    global latest_data, should_run, connection_status, serial_instance, SIMULATION_MODE, raw_buffer, smoothing_buffer
+def start_simulation():
+    if not any(t.name == 'simulation_thread' for t in threading.enumerate()):
+        sim_thread = threading.Thread(target=simulate_data, name='simulation_thread')
+        sim_thread.daemon = True
+        sim_thread.start()
+
+def handle_device_data(device, raw_data, text, frames):
+    """Trata uma leitura de um dispositivo (chamada na thread do DeviceIngest)."""
+    is_primary = device is primary_device
+    if is_primary and SIMULATION_MODE:
+        return  # O painel mostra os dados simulados
+    
+    if is_primary:
+        # Guarda os bytes brutos para o diagnóstico (cópia simples, sem formatar)
+        raw_capture.append(time.time(), raw_data)
+        if logger.isEnabledFor(logging.DEBUG):
+            logger.debug(f"Bytes recebidos: {raw_data.hex(' ')}")
+    
+    # Pontos do medidor e linhas com etiqueta, interpretados em bloco;
+    # DEBUG, BEAT, PITCH e SELFTEST não são usados aqui
+    points, tagged = parse_lines(text)
     
+    if is_primary:
+        # Colunas do espectrograma
+        for frame in frames:
+            store_spectrum(frame)
+        
+        for line in tagged:
+            # Palmas, assobios e batidas reconhecidos no microcontrolador
+            if line.startswith("SOUND:"):
+                parse_sound(line)
+            # Níveis Leq/Lmax/Lmin do último intervalo completo
+            elif line.startswith("LEQ:"):
+                parse_levels(line)
+            # Linhas de eventos sonoros gravados pelo microcontrolador
+            elif line.startswith("EVT:"):
+                event_assembler.feed_line(line)
+    
+    now = time.time()
+    for intensity, value in points:
+        # Aplicar média móvel para suavizar as leituras
+        smoothed_value = device.smoothing.add(value)
+        
+        # Log reduzido e mudado para DEBUG
+        if LOG_DATA_POINTS:
+            logger.debug(f"{device.id}: i={intensity}, v={smoothed_value:.4f} (orig={value:.4f})")
+        
+        # Cria o ponto de dados com valor suavizado
+        data_point = {
+            "intensity": intensity,
+            "value": smoothed_value,
+            "raw_value": value,  # Mantém o valor original para referência
+            "timestamp": now
+        }
+        
+        # Atualiza o histórico do dispositivo (e, no do painel, os navegadores)
+        store_data_point(data_point, device)
+
+def handle_device_status(device):
+    """Sem conseguir abrir o dispositivo do painel, passa para a simulação (como antes)."""
+    global SIMULATION_MODE
+    if (device is primary_device and device.status["connects"] == 0 and device.status["failures"] == 2
+            and app.config.get('AUTO_SWITCH_TO_SIMULATION', True) and not SIMULATION_MODE):
+        logger.warning("Ativando modo de simulação automaticamente devido a falha de conexão")
+        SIMULATION_MODE = True
+        start_simulation()
+
+ingest = DeviceIngest(devices, handle_device_data, handle_device_status, BAUD_RATE)
+
+def start_reading():
     if SIMULATION_MODE:
         logger.info("Iniciando modo de SIMULAÇÃO")
-        simulate_data()
+        start_simulation()
         return
-
-    # Se estamos no modo debug com reloader, o processo filho não deve tentar usar a porta serial
+    
+    # Se estamos no modo debug com reloader, o processo pai não deve tentar usar as portas seriais
     if os.environ.get('WERKZEUG_RUN_MAIN') != 'true' and sys.argv[0].endswith('flask'):
         logger.info("Processo pai detectado em modo reloader, ignorando inicialização serial")
         return
     
-    ser = setup_serial()
-    retry_count = 0
-    max_retries = 5
-    
-    if not ser:
-        logger.warning(f"Falha ao abrir porta serial. Tentando novamente em 5 segundos...")
-        time.sleep(5)
-        ser = setup_serial()
-    
-    if not ser:
-        logger.error("Não foi possível abrir a porta serial após tentativas. Verifique a conexão.")
-        connection_status["last_error"] = "Falha ao conectar com o dispositivo"
-        # Ativa o modo de simulação se falhar na conexão com a porta
-        if app.config.get('AUTO_SWITCH_TO_SIMULATION', True):
-            logger.warning("Ativando modo de simulação automaticamente devido a falha de conexão")
-            SIMULATION_MODE = True
-            simulate_data()
-        return
-    
-    logger.info("Iniciando leitura da porta serial...")
-    
-    while should_run:
-        try:
-            if ser.in_waiting > 0:
-                # Lê os bytes disponíveis (preserva dados brutos)
-                raw_data = ser.read(ser.in_waiting)
-                
-                if DEBUG_SERIAL:
-                    # Log dos bytes brutos
-                    hex_data = ' '.join([f"{b:02x}" for b in raw_data])
-                    logger.debug(f"Bytes recebidos: {hex_data}")
-                    
-                    # Guarda no buffer de diagnóstico
-                    timestamp = time.time()
-                    raw_buffer.append({
-                        "time": timestamp,
-                        "data_hex": hex_data,
-                        "data_str": raw_data.decode('utf-8', errors='replace')
-                    })
-                    
-                    # Limita o tamanho do buffer
-                    if len(raw_buffer) > MAX_RAW_BUFFER:
-                        raw_buffer.pop(0)
-                
-                # Tenta decodificar e processar as linhas
-                text = raw_data.decode('utf-8', errors='replace')
-                lines = text.splitlines()
-                
-                for line in lines:
-                    if not line.strip():
-                        continue  # Ignora linhas vazias
-                    
-                    # Ignora linhas de DEBUG do microcontrolador
-                    if line.startswith("DEBUG:"):
-                        continue
-                        
-                    # Mudança de INFO para DEBUG para reduzir logs no terminal
-                    if LOG_DATA_POINTS:
-                        logger.debug(f"Linha recebida: '{line}'")
-                    
-                    # O formato esperado é: "XX X.XXXX" (intensidade e valor)
-                    parts = line.split()
-                    
-                    # Tenta extrair valores mesmo com formato irregular
-                    if len(parts) != 2:
-                        # Tenta extrair números da string
-                        numbers = []
-                        current_number = ""
-                        for char in line:
-                            if char.isdigit() or char == '.':
-                                current_number += char
-                            elif current_number:
-                                numbers.append(current_number)
-                                current_number = ""
-                        
-                        if current_number:
-                            numbers.append(current_number)
-                            
-                        logger.info(f"Extração de números: {numbers}")
-                        
-                        if len(numbers) >= 2:
-                            parts = numbers[:2]
-                            logger.info(f"Usando valores extraídos: {parts}")
-                    
-                    if len(parts) >= 2:
-                        try:
-                            intensity = int(float(parts[0]))
-                            value = float(parts[1])
-                            
-                            # Aplicar média móvel para suavizar as leituras
-                            smoothing_buffer.append(value)
-                            if len(smoothing_buffer) > SMOOTHING_WINDOW:
-                                smoothing_buffer.pop(0)
-                            
-                            smoothed_value = sum(smoothing_buffer) / len(smoothing_buffer)
-                            
-                            # Log reduzido e mudado para DEBUG
-                            if LOG_DATA_POINTS:
-                                logger.debug(f"Processado: i={intensity}, v={smoothed_value:.4f} (orig={value:.4f})")
-                            
-                            # Cria o ponto de dados com valor suavizado
-                            data_point = {
-                                "intensity": intensity,
-                                "value": smoothed_value,
-                                "raw_value": value,  # Mantém o valor original para referência
-                                "timestamp": time.time()
-                            }
-                            
-                            # Atualiza dados globais
-                            latest_data = data_point
-                            
-                            # Adiciona à fila
-                            if data_queue.full():
-                                data_queue.get()
-                            data_queue.put(data_point)
-                            
-                            retry_count = 0
-                        except ValueError as e:
-                            if LOG_DATA_POINTS:
-                                logger.warning(f"Erro de conversão: '{line}' - {e}")
-                    else:
-                        if LOG_DATA_POINTS:
-                            logger.warning(f"Formato inválido: '{line}' - partes: {parts}")
-            else:
-                time.sleep(0.01)
-                
-        except Exception as e:
-            retry_count += 1
-            error_msg = f"Erro na leitura serial: {e}"
-            logger.error(error_msg)
-            connection_status["last_error"] = error_msg
-            
-            if retry_count >= max_retries:
-                logger.error("Número máximo de tentativas excedido, reconectando...")
-                if ser:
-                    try:
-                        ser.close()
-                    except:
-                        pass
-                time.sleep(2)
-                ser = setup_serial()
-                retry_count = 0
-                if not ser:
-                    logger.error("Falha ao reconectar. Nova tentativa em 5 segundos.")
-                    time.sleep(5)
-                    ser = setup_serial()
-                    if not ser:
-                        logger.error("Falha persistente na conexão serial.")
-                        break
-            
-            time.sleep(1)
-    
-    if ser:
-        try:
-            ser.close()
-            serial_instance = None
-            logger.info("Porta serial fechada")
-        except:
-            pass
+    logger.info(f"Iniciando leitura de {len(devices)} dispositivo(s)...")
+    ingest.start()
 
-# Inicia a thread de leitura serial
-serial_thread = threading.Thread(target=read_serial_data)
-serial_thread.daemon = True
-serial_thread.start()
+start_reading()
 
 @app.route('/')
 def index():
@@ -293,19 +288,62 @@ def index():
     app.logger.info(f"Renderizando página inicial com simulation_mode={SIMULATION_MODE}")
     return render_template('index.html', simulation_mode=SIMULATION_MODE)
 
+# Fluxo de itens novos (Server-Sent Events). O que chegou desde o último envio
+# vai junto, em um só evento por tipo com uma lista JSON; /api/data e
+# /api/spectrum ficam para preencher o histórico ao conectar.
+@app.route('/api/stream')
+def stream():
+    def events():
+        client = queue.Queue(maxsize=STREAM_QUEUE_SIZE)
+        with stream_lock:
+            stream_clients.append(client)
+        try:
+            yield f"event: status\ndata: {json.dumps(connection_status)}\n\n"
+            while should_run:
+                try:
+                    items = [client.get(timeout=STREAM_KEEPALIVE_S)]
+                except queue.Empty:
+                    # Mantém a conexão viva e atualiza o estado da serial
+                    yield f"event: status\ndata: {json.dumps(connection_status)}\n\n"
+                    continue
+                while True:
+                    try:
+                        items.append(client.get_nowait())
+                    except queue.Empty:
+                        break
+                
+                batches = {}
+                for kind, payload in items:
+                    batches.setdefault(kind, []).append(payload)
+                yield ''.join(f"event: {kind}\ndata: {json.dumps(batch)}\n\n" for kind, batch in batches.items())
+        finally:
+            with stream_lock:
+                stream_clients.remove(client)
+    
+    return Response(events(), mimetype='text/event-stream',
+                    headers={"Cache-Control": "no-cache", "X-Accel-Buffering": "no"})
+
+# Histórico em colunas ({"seq": [...], "timestamp": [...], ...}); com ?after=
+# vêm só os pontos com seq maior, e com ?points= no máximo essa quantidade (LTTB)
+def history_columns(device_history):
+    after = request.args.get('after', 0, type=int)
+    if after > device_history.last_seq:
+        after = 0  # Servidor reiniciado: o navegador recomeça do início
+    return downsample_columns(device_history.window(after), 'timestamp', 'value',
+                              request.args.get('points', type=int))
+
 @app.route('/api/data')
 def get_data():
-    # Converte a fila em uma lista para o JSON
-    data_list = list(data_queue.queue)
+    columns = history_columns(history)
     
     # Log detalhado para depuração
-    app.logger.info(f"API /data: Enviando {len(data_list)} registros históricos, último: {latest_data}")
+    app.logger.info(f"API /data: Enviando {len(columns['seq'])} registros históricos, último: {latest_data}")
     
     return jsonify({
         "latest": latest_data,
-        "history": data_list,
+        "history": columns,
         "status": connection_status,
-        "queue_size": data_queue.qsize(),  # Adicionar informação do tamanho da fila
+        "queue_size": len(history),  # Adicionar informação do tamanho da fila
         "sim_mode": SIMULATION_MODE        # Status do modo de simulação
     })
 
@@ -323,7 +361,7 @@ def get_status():
 # Rota para alternar o modo de simulação
 @app.route('/api/toggle_simulation')
 def toggle_simulation():
-    global SIMULATION_MODE, serial_thread, should_run
+    global SIMULATION_MODE
     
     # Inverter o modo
     SIMULATION_MODE = not SIMULATION_MODE
@@ -336,42 +374,166 @@ def toggle_simulation():
     if SIMULATION_MODE:
         logger.info("Ativando modo de simulação")
         # Inicia uma nova thread de simulação se necessário
-        if not any(t.name == 'simulation_thread' for t in threading.enumerate()):
-            sim_thread = threading.Thread(target=simulate_data, name='simulation_thread')
-            sim_thread.daemon = True
-            sim_thread.start()
+        start_simulation()
     else:
         logger.info("Desativando modo de simulação")
-        # Se desativar a simulação, limpar a fila e tentar reconectar à porta serial
+        # Se desativar a simulação, limpar a fila e voltar a ler os dispositivos
         if not connection_status["connected"]:
-            data_queue.queue.clear()  # Limpa a fila de dados
-            # Iniciar thread para tentar reconectar à porta serial
-            reconnect_thread = threading.Thread(target=read_serial_data)
-            reconnect_thread.daemon = True
-            reconnect_thread.start()
+            history.clear()  # Limpa o histórico
+        ingest.start()  # Não faz nada se já estiver lendo
     
     return jsonify({
         "simulation_mode": SIMULATION_MODE,
         "message": f"Modo de simulação {'ativado' if SIMULATION_MODE else 'desativado'}"
     })
 
+# Liga ou desliga a captura dos bytes brutos para o diagnóstico
+@app.route('/api/toggle_capture')
+def toggle_capture():
+    raw_capture.enabled = not raw_capture.enabled
+    if not raw_capture.enabled:
+        raw_capture.clear()
+    return jsonify({
+        "capture": raw_capture.enabled,
+        "message": f"Captura de bytes brutos {'ativada' if raw_capture.enabled else 'desativada'}"
+    })
+
+# Lista os últimos eventos sonoros recebidos
+@app.route('/api/events')
+def get_events():
+    return jsonify({"events": event_assembler.list_events()})
+
+# Baixa o arquivo WAV de um evento
+@app.route('/api/events/<path:filename>')
+def get_event_file(filename):
+    return send_from_directory(EVENTS_DIR, filename, mimetype='audio/wav')
+
+# Últimos níveis Leq/Lmax/Lmin (dB, ponderação A) de cada intervalo
+@app.route('/api/levels')
+def get_levels():
+    return jsonify({"levels": [latest_levels[k] for k in sorted(latest_levels)]})
+
+# Últimos sons reconhecidos, do mais antigo ao mais novo
+@app.route('/api/sounds')
+def get_sounds():
+    return jsonify({"sounds": list(sound_events)})
+
+# Colunas do espectrograma com id maior que ?after=, em base64 (um byte por faixa)
+@app.route('/api/spectrum')
+def get_spectrum():
+    after = request.args.get('after', 0, type=int)
+    if after > spectrum_last_id:
+        after = 0  # Servidor reiniciado: o navegador recomeça do início
+    frames = [{"id": frame_id, "bins": base64.b64encode(payload).decode('ascii')}
+              for frame_id, payload in list(spectrum_frames) if frame_id > after]
+    return jsonify({
+        "frames": frames,
+        "last_id": spectrum_last_id,
+        "bin_hz": SPEC_BIN_HZ
+    })
+
+# Pontos gravados entre ?from= e ?to= (tempo Unix em segundos; padrão: a última
+# hora), em colunas. ?resolution= é raw, 1s, 1m ou auto (escolhe pelo tamanho
+# do período; períodos longos vêm sempre dos agregados). Com ?points= a série
+# é reduzida por LTTB a no máximo essa quantidade, qualquer que seja o período
+@app.route('/api/range')
+def get_range():
+    end = request.args.get('to', time.time(), type=float)
+    start = request.args.get('from', end - 3600, type=float)
+    resolution = request.args.get('resolution', 'auto')
+    points = request.args.get('points', type=int)
+    span = end - start
+    
+    if resolution == 'auto':
+        if span <= RANGE_RAW_MAX_S:
+            resolution = 'raw'
+        elif span <= RANGE_1S_MAX_S:
+            resolution = '1s'
+        else:
+            resolution = '1m'
+    if resolution not in ('raw', '1s', '1m'):
+        return jsonify({"error": f"Resolução inválida: {resolution}"}), 400
+    if span < 0 or (resolution == 'raw' and span > RANGE_RAW_MAX_S):
+        return jsonify({"error": f"Período inválido para a resolução {resolution}"}), 400
+    
+    columns = series_store.query(start, end, resolution)
+    columns = downsample_columns(columns, 't', 'value' if resolution == 'raw' else 'mean', points)
+    
+    return jsonify({
+        "from": start,
+        "to": end,
+        "resolution": resolution,
+        "points": columns
+    })
+
 # Adiciona endpoint para diagnóstico
 @app.route('/api/diagnostic')
 def get_diagnostic():
     return jsonify({
-        "raw_buffer": raw_buffer,
+        "raw_buffer": raw_capture.snapshot(),
         "latest_data": latest_data,
-        "queue_size": data_queue.qsize(),
+        "queue_size": len(history),
         "simulation_mode": SIMULATION_MODE,
         "connection": connection_status,
         "app_info": {
             "time": time.time(),
-            "debug_serial": DEBUG_SERIAL,
-            "serial_port": SERIAL_PORT,
+            "debug_serial": raw_capture.enabled,
             "baud_rate": BAUD_RATE
-        }
+        },
+        "devices": [device.describe() for device in devices]
     })
 
+# Dispositivos lidos, com o estado da conexão e o último ponto de cada um
+@app.route('/api/devices')
+def get_devices():
+    return jsonify({"devices": [device.describe() for device in devices]})
+
+def find_device(device_id):
+    device = devices_by_id.get(device_id)
+    if device is None:
+        return None, (jsonify({"error": f"Dispositivo desconhecido: {device_id}"}), 404)
+    return device, None
+
+# Histórico de um dispositivo, como em /api/data (?after= e ?points=)
+@app.route('/api/devices/<device_id>/data')
+def get_device_data(device_id):
+    device, error = find_device(device_id)
+    if error:
+        return error
+    return jsonify({
+        "device": device.id,
+        "latest": device.latest,
+        "history": history_columns(device.history),
+        "status": device.status
+    })
+
+@app.route('/api/devices/<device_id>/latest')
+def get_device_latest(device_id):
+    device, error = find_device(device_id)
+    if error:
+        return error
+    return jsonify({"device": device.id, "data": device.latest, "status": device.status})
+
+@app.route('/api/devices/<device_id>/status')
+def get_device_status(device_id):
+    device, error = find_device(device_id)
+    if error:
+        return error
+    return jsonify(device.status)
+
+# Liga ou desliga a gravação dos bytes recebidos de um dispositivo (em
+# recordings/, para reproduzir com um dispositivo "replay" no devices.json)
+@app.route('/api/devices/<device_id>/record')
+def toggle_device_recording(device_id):
+    device, error = find_device(device_id)
+    if error:
+        return error
+    if device.recording:
+        device.stop_recording()
+    else:
+        device.start_recording(RECORDINGS_DIR)
+    return jsonify({"device": device.id, "recording": device.recording})
+
 if __name__ == '__main__':
     try:
         # Configuração adicional da aplicação
@@ -384,7 +546,5 @@ if __name__ == '__main__':
         app.run(debug=True, host='0.0.0.0', port=5000, use_reloader=USE_RELOADER)
     finally:
         should_run = False
-        logger.info("Encerrando thread de leitura serial...")
+        logger.info("Encerrando leitura dos dispositivos...")
         cleanup_resources()
-        if serial_thread.is_alive():
-            serial_thread.join(timeout=2)
@@ -38,6 +38,7 @@ function createDebugPanel() {
                 <button id="debug-fetch-diagnostic">Atualizar Diagnóstico</button>
                 <button id="debug-force-simulation">Forçar Simulação</button>
                 <button id="debug-clear-data">Limpar Dados</button>
+                <button id="debug-toggle-capture">Captura Raw</button>
             </div>
             <div class="debug-log">
                 <h4>Log</h4>
@@ -203,11 +204,21 @@ function createDebugPanel() {
             });
     });
     
+    document.getElementById('debug-toggle-capture').addEventListener('click', function() {
+        fetch('/api/toggle_capture')
+            .then(response => response.json())
+            .then(data => {
+                logToPanel(data.message, 'success');
+                fetchDiagnosticData();
+            })
+            .catch(error => {
+                logToPanel(`Erro ao alternar captura: ${error}`, 'error');
+            });
+    });
+    
     document.getElementById('debug-clear-data').addEventListener('click', function() {
         if (confirm('Limpar todos os dados? Isso reiniciará o gráfico.')) {
-            soundChart.data.datasets[0].data = Array(maxDataPoints).fill(0);
-            soundChart.data.labels = Array(maxDataPoints).fill('');
-            soundChart.update();
+            levelChart.clear();
             logToPanel('Dados do gráfico limpos', 'success');
         }
     });
@@ -255,7 +266,8 @@ function fetchDiagnosticData() {
                 });
                 rawBuffer.textContent = rawText;
             } else {
-                rawBuffer.textContent = 'Nenhum dado raw disponível';
+                rawBuffer.textContent = data.app_info && !data.app_info.debug_serial ?
+                    'Captura raw desativada' : 'Nenhum dado raw disponível';
             }
             
             // Log de sucesso
@@ -30,18 +30,57 @@ window.SoundMonitorDebug = {
         }
         
         if (this.lastResponse && this.lastResponse.history) {
-            console.log("Pontos no histórico:", this.lastResponse.history.length);
-            console.log("Primeiros 5 valores:", this.lastResponse.history.slice(0, 5).map(item => item.value));
+            console.log("Pontos no histórico:", this.lastResponse.history.seq.length);
+            console.log("Primeiros 5 valores:", this.lastResponse.history.value.slice(0, 5));
         }
         
-        if (window.soundChart) {
-            console.log("Dados no gráfico:", window.soundChart.data.datasets[0].data.length);
+        if (window.levelChart) {
+            console.log("Dados no gráfico:", window.levelChart.count);
         }
         
         console.log("Status da conexão:", document.getElementById('connection-status').textContent);
         console.groupEnd();
     },
     
+    // Teste de carga do gráfico: alimenta um gráfico temporário com `rate`
+    // pontos por segundo durante `seconds` segundos e informa o tempo de
+    // desenho e os quadros perdidos (intervalo maior que 1,5 quadro).
+    stressChart: function(rate = 1000, seconds = 5) {
+        const canvas = document.createElement('canvas');
+        canvas.style.cssText = 'position:fixed;left:10px;bottom:10px;width:700px;height:300px;background:white;z-index:1000';
+        document.body.appendChild(canvas);
+        const chart = new LevelChart(canvas, rate * 10, { windowS: 10 });
+
+        const start = performance.now();
+        let sent = 0, frames = 0, dropped = 0, worstDraw = 0, totalDraw = 0;
+        let lastFrame = start;
+        const feed = setInterval(() => {
+            const due = Math.floor((performance.now() - start) * rate / 1000);
+            for (; sent < due; sent++) {
+                chart.push(Date.now() / 1000, 1.65 + Math.sin(sent / 50) * (0.5 + Math.random()));
+            }
+            chart.requestDraw();
+        }, 4);
+
+        function frame(now) {
+            if (now - lastFrame > 1.5 * 1000 / 60) dropped++;
+            lastFrame = now;
+            frames++;
+            totalDraw += chart.drawMs;
+            worstDraw = Math.max(worstDraw, chart.drawMs);
+            if (now - start < seconds * 1000) {
+                requestAnimationFrame(frame);
+                return;
+            }
+            clearInterval(feed);
+            canvas.remove();
+            console.log(`Teste de carga: ${sent} pontos a ${rate}/s, ${frames} quadros, ` +
+                        `${dropped} perdidos, desenho médio ${(totalDraw / frames).toFixed(2)} ms, ` +
+                        `pior ${worstDraw.toFixed(2)} ms`);
+        }
+        requestAnimationFrame(frame);
+    },
+    
     // Simula dados de teste
     simulateTestData: function() {
         // Atualiza o medidor de nível
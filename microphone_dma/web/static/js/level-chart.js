@@ -0,0 +1,210 @@
+// Gráfico do nível de som desenhado direto no canvas, sem Chart.js.
+// Os pontos ficam em um buffer circular de arrays tipados (tempo e valor):
+// guardar um ponto são duas atribuições, sem criar objetos nem deslocar
+// arrays. O desenho acontece no máximo uma vez por quadro de animação, com o
+// que houver no buffer nesse momento. O eixo X é o tempo: a largura mostra os
+// últimos `windowS` segundos, qualquer que seja a taxa, e o buffer deve caber
+// essa janela na taxa mais alta esperada. Com mais pontos do que pixels na
+// largura, cada coluna de pixels vira um traço do mínimo ao máximo dos seus
+// pontos, então o custo do quadro depende da largura e não da taxa de pontos.
+const CHART_MARGIN = { left: 52, right: 8, top: 8, bottom: 22 };  // Eixos e rótulos, em pixels CSS
+
+class LevelChart {
+    constructor(canvas, capacity, options = {}) {
+        this.canvas = canvas;
+        this.ctx = canvas.getContext('2d');
+        this.capacity = capacity;
+        this.yMax = options.yMax || 3.3;
+        this.yStep = options.yStep || 0.5;
+        this.windowS = options.windowS || 10;      // Segundos na largura do gráfico
+        this.times = new Float64Array(capacity);   // Tempo Unix em segundos
+        this.values = new Float32Array(capacity);
+        this.head = 0;    // Próxima posição a escrever
+        this.count = 0;
+        this.drawScheduled = false;
+        this.drawMs = 0;  // Duração do último desenho (para o teste de carga)
+        this.hoverX = null;
+
+        canvas.addEventListener('mousemove', event => {
+            this.hoverX = event.offsetX;
+            this.requestDraw();
+        });
+        canvas.addEventListener('mouseleave', () => {
+            this.hoverX = null;
+            this.requestDraw();
+        });
+        window.addEventListener('resize', () => this.requestDraw());
+    }
+
+    push(timestamp, value) {
+        this.times[this.head] = timestamp;
+        this.values[this.head] = value;
+        this.head = (this.head + 1) % this.capacity;
+        if (this.count < this.capacity) this.count++;
+    }
+
+    // Troca todo o conteúdo (histórico recebido do servidor)
+    setPoints(timestamps, values) {
+        this.clear();
+        const start = Math.max(0, values.length - this.capacity);
+        for (let i = start; i < values.length; i++) this.push(timestamps[i], values[i]);
+        this.requestDraw();
+    }
+
+    clear() {
+        this.head = 0;
+        this.count = 0;
+        this.requestDraw();
+    }
+
+    // Largura da área dos pontos em pixels CSS: mais pontos do que isso não aparecem
+    plotWidth() {
+        return Math.max(this.canvas.clientWidth - CHART_MARGIN.left - CHART_MARGIN.right, 2);
+    }
+
+    // Posição no buffer do i-ésimo ponto, do mais antigo (0) ao mais novo
+    index(i) {
+        return (this.head - this.count + i + this.capacity) % this.capacity;
+    }
+
+    // Primeiro i com tempo >= t (busca binária: os tempos chegam em ordem)
+    indexAtTime(t) {
+        let lo = 0, hi = this.count;
+        while (lo < hi) {
+            const mid = (lo + hi) >> 1;
+            if (this.times[this.index(mid)] < t) lo = mid + 1;
+            else hi = mid;
+        }
+        return lo;
+    }
+
+    requestDraw() {
+        if (this.drawScheduled) return;
+        this.drawScheduled = true;
+        requestAnimationFrame(() => {
+            this.drawScheduled = false;
+            this.draw();
+        });
+    }
+
+    draw() {
+        const t0 = performance.now();
+        const canvas = this.canvas;
+        const ctx = this.ctx;
+        const ratio = window.devicePixelRatio || 1;
+        const width = canvas.clientWidth;
+        const height = canvas.clientHeight;
+        if (canvas.width !== Math.round(width * ratio) || canvas.height !== Math.round(height * ratio)) {
+            canvas.width = Math.round(width * ratio);
+            canvas.height = Math.round(height * ratio);
+        }
+        ctx.setTransform(ratio, 0, 0, ratio, 0, 0);
+        ctx.clearRect(0, 0, width, height);
+
+        const { left, right, top, bottom } = CHART_MARGIN;
+        const plotW = width - left - right;
+        const plotH = height - top - bottom;
+        if (plotW <= 0 || plotH <= 0) return;
+        const yOf = v => top + plotH * (1 - Math.min(Math.max(v / this.yMax, 0), 1));
+
+        // Grade e escala do eixo Y
+        ctx.font = '11px sans-serif';
+        ctx.fillStyle = '#666';
+        ctx.strokeStyle = '#e5e5e5';
+        ctx.lineWidth = 1;
+        ctx.textAlign = 'right';
+        ctx.textBaseline = 'middle';
+        ctx.beginPath();
+        for (let v = 0; v <= this.yMax + 1e-9; v += this.yStep) {
+            const y = Math.round(yOf(v)) + 0.5;
+            ctx.moveTo(left, y);
+            ctx.lineTo(left + plotW, y);
+            ctx.fillText(v.toFixed(2) + 'V', left - 6, y);
+        }
+        ctx.stroke();
+
+        const count = this.count;
+        if (count === 0) {
+            this.drawMs = performance.now() - t0;
+            return;
+        }
+
+        // O ponto mais novo fica na borda direita; a largura cobre `windowS` segundos
+        const times = this.times;
+        const values = this.values;
+        const newest = times[this.index(count - 1)];
+        const pxPerS = plotW / this.windowS;
+        const xOf = t => left + plotW - (newest - t) * pxPerS;
+        const first = this.indexAtTime(newest - this.windowS);
+        const baseline = yOf(0);
+
+        // Pontos da mesma coluna de pixels viram um traço do mínimo ao máximo
+        ctx.beginPath();
+        let column = null, columnX = 0, min = 0, max = 0;
+        let firstX = null, lastX = 0;
+        const emit = () => {
+            if (firstX === null) {
+                ctx.moveTo(columnX, yOf(min));
+                firstX = columnX;
+            } else {
+                ctx.lineTo(columnX, yOf(min));
+            }
+            if (max !== min) ctx.lineTo(columnX, yOf(max));
+            lastX = columnX;
+        };
+        for (let i = first; i < count; i++) {
+            const k = this.index(i);
+            const x = xOf(times[k]);
+            const v = values[k];
+            if (Math.floor(x) !== column) {
+                if (column !== null) emit();
+                column = Math.floor(x);
+                columnX = x;
+                min = max = v;
+            } else {
+                if (v < min) min = v;
+                if (v > max) max = v;
+            }
+        }
+        emit();
+        ctx.strokeStyle = 'rgb(75, 192, 192)';
+        ctx.lineWidth = 2;
+        ctx.stroke();
+        ctx.lineTo(lastX, baseline);
+        ctx.lineTo(firstX, baseline);
+        ctx.closePath();
+        ctx.fillStyle = 'rgba(75, 192, 192, 0.2)';
+        ctx.fill();
+
+        // Horários do ponto mais antigo na tela e do mais novo
+        ctx.fillStyle = '#666';
+        ctx.textBaseline = 'top';
+        ctx.textAlign = 'left';
+        ctx.fillText(formatTimestamp(times[this.index(first)]), Math.max(left, firstX), top + plotH + 6);
+        ctx.textAlign = 'right';
+        ctx.fillText(formatTimestamp(newest), left + plotW, top + plotH + 6);
+
+        // Valor sob o cursor: o ponto mais próximo no tempo
+        if (this.hoverX !== null && this.hoverX >= left) {
+            const t = newest - (left + plotW - this.hoverX) / pxPerS;
+            let i = this.indexAtTime(t);
+            if (i > first && (i === count || t - times[this.index(i - 1)] < times[this.index(i)] - t)) i--;
+            if (i >= first && i < count) {
+                const x = xOf(times[this.index(i)]);
+                const v = values[this.index(i)];
+                ctx.strokeStyle = '#999';
+                ctx.lineWidth = 1;
+                ctx.beginPath();
+                ctx.moveTo(x, top);
+                ctx.lineTo(x, top + plotH);
+                ctx.stroke();
+                ctx.fillStyle = 'rgba(0, 0, 0, 0.8)';
+                ctx.textAlign = x > left + plotW / 2 ? 'right' : 'left';
+                ctx.fillText(`Amplitude: ${v.toFixed(4)}V  ${formatTimestamp(this.times[this.index(i)])}`,
+                             x + (ctx.textAlign === 'right' ? -6 : 6), top + 2);
+            }
+        }
+
+        this.drawMs = performance.now() - t0;
+    }
+}
@@ -1,8 +1,8 @@
-// Configuração do gráfico
-const ctx = document.getElementById('soundChart').getContext('2d');
-const maxDataPoints = 100;
-const initialData = Array(maxDataPoints).fill(0);
-const initialLabels = Array(maxDataPoints).fill('');
+// Configuração do gráfico: os últimos CHART_WINDOW_S segundos na largura, e
+// um buffer que comporta essa janela mesmo com o fluxo a CHART_MAX_RATE_HZ
+// (o histórico do servidor, HISTORY_SIZE, é só o preenchimento inicial)
+const CHART_WINDOW_S = 10;
+const CHART_MAX_RATE_HZ = 1000;
 
 // Debug mode
 const DEBUG = false;  // Desativar modo de debug padrão para reduzir logs no console
@@ -15,73 +15,10 @@ function debugLog(message) {
     }
 }
 
-// Configurações do gráfico com maior precisão
-const chartOptions = {
-    responsive: true,
-    maintainAspectRatio: false,
-    scales: {
-        y: {
-            beginAtZero: true,
-            max: 3.3,  // Limite máximo da escala
-            precision: 0.01,  // Precisão decimal
-            title: {
-                display: true,
-                text: 'Amplitude (V)'
-            },
-            ticks: {
-                // Número de casas decimais nos valores do eixo Y
-                callback: function(value) {
-                    return value.toFixed(2) + 'V';
-                }
-            }
-        },
-        x: {
-            title: {
-                display: true,
-                text: 'Tempo'
-            }
-        }
-    },
-    plugins: {
-        tooltip: {
-            callbacks: {
-                label: function(context) {
-                    return `Amplitude: ${context.parsed.y.toFixed(4)}V`;
-                }
-            }
-        }
-    },
-    animation: {
-        duration: 0  // Desativar animações para melhor desempenho
-    },
-    elements: {
-        point: {
-            radius: 0,  // Não mostrar pontos no gráfico para linhas mais suaves
-            hitRadius: 8  // Área para detectar hover
-        },
-        line: {
-            tension: 0.3  // Suavizar a linha um pouco
-        }
-    }
-};
-
-// Criar o gráfico
-const soundChart = new Chart(ctx, {
-    type: 'line',
-    data: {
-        labels: initialLabels,
-        datasets: [{
-            label: 'Nível de Som',
-            data: initialData,
-            borderColor: 'rgb(75, 192, 192)',
-            backgroundColor: 'rgba(75, 192, 192, 0.2)',
-            borderWidth: 2,
-            tension: 0.2,
-            fill: true
-        }]
-    },
-    options: chartOptions
-});
+// Gráfico em canvas com buffer circular (ver level-chart.js)
+const levelChart = new LevelChart(document.getElementById('soundChart'), CHART_WINDOW_S * CHART_MAX_RATE_HZ,
+                                  { yMax: 3.3, windowS: CHART_WINDOW_S });
+window.levelChart = levelChart;
 
 // Função para formatar a hora atual
 function formatTime() {
@@ -129,15 +66,28 @@ function updateCurrentLevel(value) {
     levelValue.textContent = value.toFixed(3) + 'V';
 }
 
+// Maior número de sequência já desenhado (os pontos vêm numerados do servidor)
+let lastSeq = 0;
+
 // Contador de falhas consecutivas
 let consecutiveFailures = 0;
 const maxConsecutiveFailures = 5;
 
-// Função para buscar dados e atualizar o gráfico
+// Pontos do fluxo que chegam enquanto o histórico está a caminho (null fora
+// da busca): entram depois dele, para não serem apagados nem ficarem fora de ordem
+let backfillPending = null;
+
+// Função para buscar o histórico e atualizar o gráfico (ao conectar o fluxo e
+// a cada reconexão; os pontos seguintes chegam por /api/stream). Depois da
+// primeira carga, pede só o que veio depois do último ponto desenhado.
 function fetchAndUpdateChart() {
-    debugLog("Buscando dados...");
+    if (backfillPending) return;  // Já há uma busca em andamento
+    backfillPending = [];
+    const after = lastSeq;
+    debugLog(`Buscando dados depois de ${after}...`);
     
-    fetch('/api/data')
+    // No máximo um ponto por pixel da largura do gráfico (o servidor reduz com LTTB)
+    fetch(`/api/data?points=${levelChart.plotWidth()}&after=${after}`)
         .then(response => {
             if (!response.ok) {
                 throw new Error(`HTTP error ${response.status}`);
@@ -150,7 +100,7 @@ function fetchAndUpdateChart() {
             
             // Log detalhado do conteúdo recebido
             debugLog(`Dados recebidos - Modo simulação: ${data.sim_mode}`);
-            debugLog(`Tamanho do histórico: ${data.history ? data.history.length : 'N/A'}`);
+            debugLog(`Tamanho do histórico: ${data.history ? data.history.seq.length : 'N/A'}`);
             debugLog(`Tamanho da fila: ${data.queue_size || 'N/A'}`);
             
             if (data.latest) {
@@ -185,29 +135,28 @@ function fetchAndUpdateChart() {
                 debugLog("ERRO: Dados 'latest' não encontrados na resposta");
             }
             
-            // Atualiza o gráfico com os dados históricos
+            // Atualiza o gráfico com os dados históricos (uma lista por campo)
             const history = data.history;
             
-            if (history && history.length > 0) {
-                debugLog(`Atualizando gráfico com ${history.length} pontos de dados`);
-                
-                // Criar arrays para valores e rótulos
-                const values = history.map(item => item.value);
-                const times = history.map(item => {
-                    const date = new Date(item.timestamp * 1000);
-                    return `${date.getHours().toString().padStart(2, '0')}:${date.getMinutes().toString().padStart(2, '0')}:${date.getSeconds().toString().padStart(2, '0')}`;
-                });
+            if (history && history.seq.length > 0) {
+                debugLog(`Atualizando gráfico com ${history.seq.length} pontos de dados`);
                 
                 // Mostrar alguns dados no console para depuração
-                if (values.length > 0) {
-                    debugLog(`Exemplo de valores: [${values.slice(0, 3).join(", ")}...]`);
-                }
+                debugLog(`Exemplo de valores: [${history.value.slice(0, 3).join(", ")}...]`);
                 
                 // Atualizar o gráfico
-                soundChart.data.datasets[0].data = values;
-                soundChart.data.labels = times;
-                soundChart.update('none'); // Usar 'none' para animação mais rápida
-                debugLog(`Gráfico atualizado com ${values.length} pontos`);
+                if (after > 0 && history.seq[0] > after) {
+                    // Só o que faltou desde o último ponto desenhado
+                    for (let i = 0; i < history.seq.length; i++) {
+                        levelChart.push(history.timestamp[i], history.value[i]);
+                    }
+                    levelChart.requestDraw();
+                } else {
+                    // Primeira carga, ou o servidor reiniciou e a numeração recomeçou
+                    levelChart.setPoints(history.timestamp, history.value);
+                }
+                lastSeq = history.seq[history.seq.length - 1];
+                debugLog(`Gráfico atualizado com ${history.value.length} pontos`);
                 
                 // Salvar os dados para depuração
                 window.SoundMonitorDebug.saveResponse(data);
@@ -227,36 +176,106 @@ function fetchAndUpdateChart() {
             
             document.getElementById('connection-status').textContent = `Desconectado (${consecutiveFailures})`;
             document.getElementById('connection-status').className = 'disconnected';
-            
-            // Se houver muitas falhas consecutivas, aumentar o intervalo de polling
-            if (consecutiveFailures >= maxConsecutiveFailures) {
-                debugLog("Muitas falhas consecutivas, aumentando intervalo de polling");
-                clearInterval(pollInterval);
-                pollInterval = setInterval(fetchAndUpdateChart, 5000); // Polling a cada 5 segundos
-            }
+        })
+        .finally(() => {
+            // Os pontos que chegaram durante a busca; os já vistos no histórico são pulados
+            const pending = backfillPending;
+            backfillPending = null;
+            addPoints(pending);
         });
 }
 
-// Primeira atualização
-fetchAndUpdateChart();
+function formatTimestamp(timestamp) {
+    const date = new Date(timestamp * 1000);
+    return `${date.getHours().toString().padStart(2, '0')}:${date.getMinutes().toString().padStart(2, '0')}:${date.getSeconds().toString().padStart(2, '0')}`;
+}
 
-// Atualizar o gráfico a cada segundo
-let pollInterval = setInterval(fetchAndUpdateChart, 1000);
+// Pontos recebidos pelo fluxo vão direto para o buffer do gráfico; o desenho
+// e os indicadores são atualizados uma vez por quadro de animação, com o
+// último ponto que chegou nesse intervalo.
+let latestPoint = null;
+let indicatorsScheduled = false;
 
-// Adicionar feedback visual de conexão
-window.addEventListener('load', function() {
-    debugLog("Página carregada, iniciando...");
-    // Primeira atualização imediata
-    fetchAndUpdateChart();
-});
+function addPoints(points) {
+    if (backfillPending) {
+        backfillPending.push(...points);
+        return;
+    }
+    for (const point of points) {
+        if (point.seq <= lastSeq) continue;  // Já veio pelo histórico
+        levelChart.push(point.timestamp, point.value);
+        lastSeq = point.seq;
+        latestPoint = point;
+    }
+    if (!latestPoint) return;
+    levelChart.requestDraw();
+    if (!indicatorsScheduled) {
+        indicatorsScheduled = true;
+        requestAnimationFrame(updateIndicators);
+    }
+}
+
+function updateIndicators() {
+    indicatorsScheduled = false;
+    updateCurrentLevel(latestPoint.value);
+    updateIntensityBars(latestPoint.intensity);
+    document.getElementById('last-update').textContent = formatTime();
+}
+
+function updateConnectionStatus(status) {
+    const element = document.getElementById('connection-status');
+    if (status.connected) {
+        element.textContent = 'Conectado';
+        element.className = 'connected';
+    } else {
+        element.textContent = 'Desconectado: ' + status.last_error;
+        element.className = 'disconnected';
+    }
+}
+
+// Fluxo de pontos novos (Server-Sent Events), compartilhado com o espectrograma
+let pollInterval = null;
+window.soundStream = null;
+
+function startStream() {
+    if (!window.EventSource) {
+        fetchAndUpdateChart();
+        pollInterval = setInterval(fetchAndUpdateChart, 1000); // Navegador sem SSE: volta ao polling
+        return;
+    }
+
+    const stream = new EventSource('/api/stream');
+    window.soundStream = stream;
+
+    // Ao conectar (e a cada reconexão automática), preenche o que faltou.
+    stream.addEventListener('open', () => {
+        debugLog("Fluxo conectado");
+        consecutiveFailures = 0;
+        fetchAndUpdateChart();
+    });
+
+    stream.addEventListener('data', event => addPoints(JSON.parse(event.data)));
+
+    stream.addEventListener('status', event => updateConnectionStatus(JSON.parse(event.data)));
+
+    stream.addEventListener('error', () => {
+        // O EventSource tenta reconectar sozinho
+        consecutiveFailures++;
+        document.getElementById('connection-status').textContent = `Desconectado (${consecutiveFailures})`;
+        document.getElementById('connection-status').className = 'disconnected';
+    });
+}
+
+// A primeira carga do histórico vem do evento 'open' do fluxo
+startStream();
 
 // Adicionar botão para depuração no console
 window.debugData = function() {
     console.log("Últimos dados recebidos:", lastReceivedData);
     if (lastReceivedData && lastReceivedData.history) {
-        console.log(`Total de pontos no histórico: ${lastReceivedData.history.length}`);
+        console.log(`Total de pontos no histórico: ${lastReceivedData.history.seq.length}`);
     }
-    console.log("Estado atual do gráfico:", soundChart.data);
+    console.log(`Pontos no gráfico: ${levelChart.count}, último desenho: ${levelChart.drawMs.toFixed(2)} ms`);
 };
 
 // Adiciona função para forçar atualização
@@ -0,0 +1,112 @@
+// Espectrograma em cascata: cada coluna recebida do firmware vira uma coluna
+// de pixels à direita do canvas, e o resto da imagem anda uma coluna para a
+// esquerda. Só a coluna nova é pintada; nada é redesenhado do zero.
+(function() {
+    const canvas = document.getElementById('spectrogramCanvas');
+    if (!canvas) return;
+
+    const SPECTRUM_POLL_MS = 100;  // Só sem o fluxo: o firmware envia 20 colunas por segundo
+    const ctx = canvas.getContext('2d');
+    let afterId = 0;
+    let binHz = 0;
+    let pendingColumns = [];    // Recebidas e ainda não pintadas
+    let drawScheduled = false;
+    let column = null;  // ImageData de 1 pixel de largura, reaproveitado
+    let columnPixels = null;
+
+    // Tabela de 256 cores (0 = silêncio, 255 = fundo de escala) em RGBA
+    // empacotado, para escrever cada pixel com uma única atribuição.
+    const colorTable = new Uint32Array(256);
+    (function buildColorTable() {
+        const stops = [
+            [0, 0, 0, 4], [64, 60, 15, 110], [128, 180, 55, 85],
+            [192, 250, 140, 10], [255, 252, 255, 164]
+        ];
+        const bytes = new Uint8Array(colorTable.buffer);
+        for (let v = 0; v < 256; v++) {
+            let s = 0;
+            while (stops[s + 1][0] < v) s++;
+            const [v0, r0, g0, b0] = stops[s];
+            const [v1, r1, g1, b1] = stops[s + 1];
+            const t = (v - v0) / (v1 - v0);
+            bytes[v * 4] = r0 + (r1 - r0) * t;
+            bytes[v * 4 + 1] = g0 + (g1 - g0) * t;
+            bytes[v * 4 + 2] = b0 + (b1 - b0) * t;
+            bytes[v * 4 + 3] = 255;
+        }
+    })();
+
+    function setupCanvas(bins) {
+        canvas.height = bins;  // Um pixel por faixa; o CSS estica para o tamanho do cartão
+        ctx.fillStyle = 'black';
+        ctx.fillRect(0, 0, canvas.width, canvas.height);
+        column = ctx.createImageData(1, bins);
+        columnPixels = new Uint32Array(column.data.buffer);
+    }
+
+    function decodeBins(encoded) {
+        const text = atob(encoded);
+        const bins = new Uint8Array(text.length);
+        for (let i = 0; i < text.length; i++) bins[i] = text.charCodeAt(i);
+        return bins;
+    }
+
+    function drawColumns(columns) {
+        if (!column || column.height !== columns[0].length) setupCanvas(columns[0].length);
+
+        const count = Math.min(columns.length, canvas.width);
+        // Desloca a imagem atual para a esquerda e pinta só as colunas novas.
+        ctx.drawImage(canvas, -count, 0);
+        for (let i = 0; i < count; i++) {
+            const bins = columns[columns.length - count + i];
+            // Frequências baixas embaixo.
+            for (let k = 0; k < bins.length; k++) {
+                columnPixels[bins.length - 1 - k] = colorTable[bins[k]];
+            }
+            ctx.putImageData(column, canvas.width - count + i, 0);
+        }
+    }
+
+    function showColumns(frames, binHz) {
+        const columns = frames.filter(frame => frame.id > afterId).map(frame => decodeBins(frame.bins));
+        if (frames.length) afterId = Math.max(afterId, frames[frames.length - 1].id);
+        if (!columns.length) return;
+
+        if (binHz) {
+            document.getElementById('spectrogram-range').textContent =
+                `0 - ${(binHz * columns[0].length / 1000).toFixed(1)} kHz`;
+        }
+        pendingColumns.push(...columns);
+        if (!drawScheduled) {
+            drawScheduled = true;
+            requestAnimationFrame(() => {
+                drawScheduled = false;
+                drawColumns(pendingColumns);
+                pendingColumns = [];
+            });
+        }
+    }
+
+    // Colunas que faltam (ao abrir a página, ao reconectar ou sem o fluxo).
+    function fetchSpectrum() {
+        return fetch(`/api/spectrum?after=${afterId}`)
+            .then(response => response.json())
+            .then(data => {
+                if (data.last_id < afterId) afterId = 0;  // Servidor reiniciado
+                binHz = data.bin_hz;
+                showColumns(data.frames, binHz);
+            })
+            .catch(error => console.error('Erro ao buscar o espectrograma:', error));
+    }
+
+    const stream = window.soundStream;
+    if (stream) {
+        // Colunas novas chegam pelo fluxo compartilhado com o gráfico (script.js).
+        stream.addEventListener('open', fetchSpectrum);
+        stream.addEventListener('spectrum', event => showColumns(JSON.parse(event.data), binHz));
+    } else {
+        (function poll() {
+            fetchSpectrum().finally(() => setTimeout(poll, SPECTRUM_POLL_MS));
+        })();
+    }
+})();
@@ -0,0 +1,151 @@
+"""
+Benchmark de /api/data e /api/latest com vários navegadores ao mesmo tempo.
+
+Uso: python -m utils.bench_http [--clients 1,10,50,100,500] [--duration 5]   (a partir de web/)
+
+O app.py sobe em outro processo, em uma porta livre, lendo uma gravação
+sintética (dispositivo "replay", ver serial_recording.py) em vez da serial e
+guardando os dados em um diretório temporário: nada de hardware nem de
+serviços externos, e a mesma carga a cada execução. Os clientes são
+corrotinas asyncio com HTTP escrito à mão; cada um repete a requisição até o
+fim do tempo, em uma conexão nova por requisição (o servidor de
+desenvolvimento fecha a conexão a cada resposta). Para cada rota e número de
+clientes, mostra requisições por segundo e a latência p50 e p99.
+"""
+import os
+import sys
+import json
+import math
+import time
+import socket
+import asyncio
+import argparse
+import platform
+import tempfile
+import subprocess
+
+from utils.serial_recording import SerialRecorder
+
+WEB_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+ROUTES = ('/api/data', '/api/latest')
+DEFAULT_CLIENTS = '1,10,50,100,500'
+SAMPLE_RATE = 100     # Pontos por segundo na gravação sintética
+RECORDING_S = 10      # Reproduzida em laço
+STARTUP_TIMEOUT_S = 15
+
+
+def write_recording(path):
+    """Gravação com uma senoide no formato do medidor ("intensidade valor")."""
+    recorder = SerialRecorder(path)
+    for i in range(SAMPLE_RATE * RECORDING_S):
+        value = 1.65 + 1.5 * math.sin(i / 20)
+        recorder.write(f"{int(value * 1.5)} {value:.4f}\r\n".encode(), i / SAMPLE_RATE)
+    recorder.close()
+
+
+def free_port():
+    with socket.socket() as s:
+        s.bind(('127.0.0.1', 0))
+        return s.getsockname()[1]
+
+
+def start_server(tmp, port):
+    recording = os.path.join(tmp, 'bench.srec')
+    write_recording(recording)
+    devices_file = os.path.join(tmp, 'devices.json')
+    with open(devices_file, 'w', encoding='utf-8') as f:
+        json.dump([{"id": "bench", "type": "replay", "file": recording, "loop": True}], f)
+
+    env = dict(os.environ, DEVICES_FILE=devices_file, DATA_DIR=os.path.join(tmp, 'data'))
+    code = f"import app; app.app.run(host='127.0.0.1', port={port}, threaded=True)"
+    return subprocess.Popen([sys.executable, '-c', code], cwd=WEB_DIR, env=env,
+                            stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+
+
+async def get(port, path):
+    """Uma requisição GET; devolve o corpo da resposta."""
+    reader, writer = await asyncio.open_connection('127.0.0.1', port)
+    try:
+        writer.write(f"GET {path} HTTP/1.1\r\nHost: 127.0.0.1:{port}\r\nConnection: close\r\n\r\n".encode())
+        response = await reader.read()
+    finally:
+        writer.close()
+    head, _, body = response.partition(b'\r\n\r\n')
+    if not head.startswith((b'HTTP/1.0 200', b'HTTP/1.1 200')):
+        raise ConnectionError(head.split(b'\r\n', 1)[0].decode(errors='replace') or 'resposta vazia')
+    return body
+
+
+async def wait_ready(port, proc):
+    """Espera o servidor responder e o histórico estar cheio."""
+    deadline = time.monotonic() + STARTUP_TIMEOUT_S
+    while time.monotonic() < deadline:
+        if proc.poll() is not None:
+            raise RuntimeError(f"app.py terminou com código {proc.returncode}")
+        try:
+            data = json.loads(await get(port, '/api/data'))
+            if data['queue_size'] > 0 and data['status']['connected']:
+                await asyncio.sleep(1)  # Tempo de encher o histórico (HISTORY_SIZE pontos)
+                return
+        except (OSError, ValueError):
+            pass
+        await asyncio.sleep(0.2)
+    raise RuntimeError("app.py não ficou pronto a tempo")
+
+
+async def client(port, path, deadline, latencies, errors):
+    while time.perf_counter() < deadline:
+        t0 = time.perf_counter()
+        try:
+            await get(port, path)
+        except OSError:
+            errors.append(time.perf_counter() - t0)
+            await asyncio.sleep(0.01)
+            continue
+        latencies.append(time.perf_counter() - t0)
+
+
+async def run_level(port, path, clients, duration):
+    latencies, errors = [], []
+    t0 = time.perf_counter()
+    await asyncio.gather(*(client(port, path, t0 + duration, latencies, errors) for _ in range(clients)))
+    return latencies, len(errors), time.perf_counter() - t0
+
+
+def percentile(values, p):
+    return values[min(len(values) - 1, round(p * (len(values) - 1)))] if values else float('nan')
+
+
+async def bench(port, proc, levels, duration):
+    await wait_ready(port, proc)
+    print(f"{'rota':<12} {'clientes':>8} {'req/s':>9} {'p50 ms':>9} {'p99 ms':>9} {'erros':>6}")
+    for path in ROUTES:
+        await run_level(port, path, 1, 0.5)  # Aquecimento
+        for clients in levels:
+            latencies, errors, elapsed = await run_level(port, path, clients, duration)
+            latencies.sort()
+            print(f"{path:<12} {clients:>8} {len(latencies) / elapsed:9.1f} "
+                  f"{1e3 * percentile(latencies, 0.5):9.2f} {1e3 * percentile(latencies, 0.99):9.2f} {errors:>6}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument('--clients', default=DEFAULT_CLIENTS, help=f"clientes simultâneos (padrão: {DEFAULT_CLIENTS})")
+    parser.add_argument('--duration', type=float, default=5, help="segundos por medida (padrão: 5)")
+    args = parser.parse_args()
+    levels = [int(n) for n in args.clients.split(',')]
+
+    print(f"Python {platform.python_version()}, {os.cpu_count()} CPUs, {args.duration:g} s por medida, "
+          f"dispositivo a {SAMPLE_RATE} pontos/s")
+    with tempfile.TemporaryDirectory() as tmp:
+        port = free_port()
+        proc = start_server(tmp, port)
+        try:
+            asyncio.run(bench(port, proc, levels, args.duration))
+        finally:
+            proc.terminate()
+            proc.wait()
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,72 @@
+"""
+Benchmark do custo da captura de bytes brutos por leitura da serial.
+
+Uso: python -m utils.bench_raw_capture   (a partir de web/)
+
+Compara o diagnóstico antigo (hexadecimal e texto montados a cada leitura,
+lista com pop(0)) com a RawCapture ligada e desligada, sobre as mesmas
+leituras do fluxo sintético do bench_serial_lines. Mede também o custo de
+montar o diagnóstico (snapshot), que agora só acontece em /api/diagnostic.
+"""
+import time
+
+from utils.raw_capture import RawCapture
+from utils.bench_serial_lines import synthetic_stream, chunks
+
+ROUNDS = 5
+MAX_RAW_BUFFER = 100
+RAW_CAPTURE_BYTES = 256 * 1024  # Como no app.py
+
+
+def legacy_capture(pieces):
+    raw_buffer = []
+    for raw in pieces:
+        hex_data = ' '.join([f"{b:02x}" for b in raw])
+        raw_buffer.append({
+            "time": time.time(),
+            "data_hex": hex_data,
+            "data_str": raw.decode('utf-8', errors='replace')
+        })
+        if len(raw_buffer) > MAX_RAW_BUFFER:
+            raw_buffer.pop(0)
+
+
+def ring_capture(enabled):
+    def run(pieces):
+        capture = RawCapture(RAW_CAPTURE_BYTES, MAX_RAW_BUFFER, enabled=enabled)
+        for raw in pieces:
+            capture.append(time.time(), raw)
+    return run
+
+
+def best_time(fn, pieces):
+    best = None
+    for _ in range(ROUNDS):
+        t0 = time.perf_counter()
+        fn(pieces)
+        dt = time.perf_counter() - t0
+        best = dt if best is None else min(best, dt)
+    return best
+
+
+def main():
+    data = synthetic_stream()
+    pieces = list(chunks(data))
+    print(f"{len(pieces)} leituras, {len(data)} bytes (média de {len(data) // len(pieces)} bytes por leitura)")
+    print(f"{'captura':<28} {'us/leitura':>12} {'ns/byte':>10}")
+    for name, fn in (("antiga (formata na leitura)", legacy_capture),
+                     ("buffer circular, ligada", ring_capture(True)),
+                     ("buffer circular, desligada", ring_capture(False))):
+        t = best_time(fn, pieces)
+        print(f"{name:<28} {1e6 * t / len(pieces):12.2f} {1e9 * t / len(data):10.2f}")
+
+    capture = RawCapture(RAW_CAPTURE_BYTES, MAX_RAW_BUFFER)
+    for raw in pieces:
+        capture.append(time.time(), raw)
+    t0 = time.perf_counter()
+    entries = capture.snapshot()
+    print(f"snapshot para /api/diagnostic: {1e3 * (time.perf_counter() - t0):.2f} ms ({len(entries)} leituras)")
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,145 @@
+"""
+Benchmark da leitura do texto serial: linhas por segundo.
+
+Uso: python -m utils.bench_serial_lines [arquivo_bruto]   (a partir de web/)
+
+Compara a leitura antiga (decodifica cada leitura, splitlines e extração de
+números caractere a caractere) com SerialDemux + parse_lines, entregando o
+mesmo fluxo em pedaços de tamanho aleatório, como chegam do ser.read().
+Sem arquivo, gera um fluxo parecido com o do firmware atual (medidor, DEBUG,
+BEAT, LEQ, SOUND e colunas do espectrograma). Confere também que a leitura
+em pedaços dá o mesmo resultado que a leitura do fluxo inteiro de uma vez.
+"""
+import sys
+import time
+import random
+
+from utils.serial_frames import SerialDemux, FRAME_START
+from utils.serial_lines import parse_lines
+
+CHUNK_MIN = 16
+CHUNK_MAX = 4096
+ROUNDS = 5  # Vale a melhor rodada
+
+
+def spectrum_frame(seq, rng):
+    payload = bytes(rng.randrange(0, 256) for _ in range(128))
+    body = bytes([ord('S'), seq & 0xFF, len(payload)]) + payload
+    return bytes([FRAME_START]) + body + bytes([sum(body) & 0xFF])
+
+
+def synthetic_stream(seconds=60):
+    """Fluxo de texto e quadros equivalente a alguns segundos do firmware"""
+    rng = random.Random(1)
+    out = bytearray()
+    for tick in range(seconds * 20):  # Um bloco de 50 ms por vez
+        for _ in range(10):
+            out += b"%d %.4f\r\n" % (rng.randrange(0, 5), rng.random() * 0.2)
+        out += spectrum_frame(tick, rng)
+        if tick % 20 == 0:
+            out += b"DEBUG: Ciclo %d\r\nDEBUG: Piso 12 Teto 800\r\n" % tick
+            out += b"LEQ: 1 52.3 61.0 40.2\r\n"
+        if tick % 7 == 0:
+            out += b"BEAT: %d 900\r\n" % (tick * 50000)
+        if tick % 40 == 0:
+            out += b"SOUND: %d 1 palma 812\r\n" % (tick * 50000)
+    return bytes(out)
+
+
+def chunks(data, seed=2):
+    rng = random.Random(seed)
+    pos = 0
+    while pos < len(data):
+        size = rng.randrange(CHUNK_MIN, CHUNK_MAX)
+        yield data[pos:pos + size]
+        pos += size
+
+
+def legacy_read(pieces):
+    """A leitura antiga do app.py, sem o resto da aplicação"""
+    points = 0
+    tagged = 0
+    for raw in pieces:
+        for line in raw.decode('utf-8', errors='replace').splitlines():
+            if not line.strip() or line.startswith("DEBUG:"):
+                continue
+            if line.startswith(("BEAT:", "PITCH:", "SELFTEST:", "SOUND:", "LEQ:", "EVT:")):
+                tagged += 1
+                continue
+            parts = line.split()
+            if len(parts) != 2:
+                numbers = []
+                current_number = ""
+                for char in line:
+                    if char.isdigit() or char == '.':
+                        current_number += char
+                    elif current_number:
+                        numbers.append(current_number)
+                        current_number = ""
+                if current_number:
+                    numbers.append(current_number)
+                if len(numbers) >= 2:
+                    parts = numbers[:2]
+            if len(parts) >= 2:
+                try:
+                    int(float(parts[0]))
+                    float(parts[1])
+                    points += 1
+                except ValueError:
+                    pass
+    return points, tagged
+
+
+def bulk_read(pieces):
+    demux = SerialDemux()
+    points = []
+    tagged = []
+    for raw in pieces:
+        text, frames = demux.feed(raw)
+        p, t = parse_lines(text)
+        points += p
+        tagged += t
+    return points, tagged
+
+
+def best_time(fn, pieces):
+    best = None
+    for _ in range(ROUNDS):
+        t0 = time.perf_counter()
+        result = fn(pieces)
+        dt = time.perf_counter() - t0
+        best = dt if best is None else min(best, dt)
+    return best, result
+
+
+def main():
+    if len(sys.argv) > 1:
+        with open(sys.argv[1], 'rb') as f:
+            data = f.read()
+        source = sys.argv[1]
+    else:
+        data = synthetic_stream()
+        source = "fluxo sintético"
+
+    pieces = list(chunks(data))
+    lines = data.count(b'\n') or data.count(b'\r')
+
+    whole = bulk_read([data])
+    t_bulk, split = best_time(bulk_read, pieces)
+    t_legacy, legacy = best_time(legacy_read, pieces)
+
+    print(f"{source}: {len(data)} bytes, {lines} linhas, {len(pieces)} leituras de {CHUNK_MIN} a {CHUNK_MAX} bytes")
+    print(f"{'leitura':<24} {'linhas/s':>12} {'pontos':>8} {'etiquetas':>10}")
+    print(f"{'antiga (linha a linha)':<24} {lines / t_legacy:12.0f} {legacy[0]:8d} {legacy[1]:10d}")
+    print(f"{'em bloco':<24} {lines / t_bulk:12.0f} {len(split[0]):8d} {len(split[1]):10d}")
+    print(f"ganho: {t_legacy / t_bulk:.1f}x")
+
+    if split != whole:
+        print("ERRO: a leitura em pedaços difere da leitura do fluxo inteiro")
+        return 1
+    print("leitura em pedaços igual à do fluxo inteiro")
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
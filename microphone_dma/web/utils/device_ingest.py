@@ -0,0 +1,322 @@
+"""
+Leitura simultânea de vários microcontroladores: portas seriais e conexões
+TCP ou UDP (por exemplo, placas com Wi-Fi ou um conversor serial-rede), além
+da reprodução de gravações (ver serial_recording.py) para testes sem hardware.
+
+Todas as fontes rodam em um único laço asyncio, em uma thread própria. TCP e
+UDP usam os transportes do asyncio; a pyserial só tem leitura bloqueante,
+então cada porta serial lê em uma thread de um pool com uma thread por porta,
+com timeout curto para o laço poder encerrar a leitura.
+
+Cada dispositivo tem o seu SerialDemux (o resto de uma linha incompleta fica
+nele até a próxima leitura), o seu histórico e a sua média móvel, e o seu
+estado de conexão. Uma fonte que cai é reaberta sozinha, com espera crescente
+entre as tentativas. A aplicação recebe os dados de cada leitura já separados
+em texto e quadros, chamada na thread do laço.
+
+Os dispositivos são descritos por uma lista JSON (devices.json):
+    [{"id": "sala1", "type": "serial", "port": "COM4", "record": true},
+     {"id": "sala2", "type": "tcp", "host": "192.168.0.20", "port": 5000},
+     {"id": "sala3", "type": "udp", "port": 6000},
+     {"id": "teste", "type": "replay", "file": "recordings/sala1.srec", "speed": 10, "loop": true}]
+"record" grava tudo o que chega do dispositivo desde o início. Uma gravação
+reproduzida passa pelo mesmo caminho dos dados reais, no ritmo em que foi
+gravada multiplicado por "speed" (1 a 100 vezes, por exemplo).
+"""
+import os
+import re
+import json
+import time
+import asyncio
+import logging
+import threading
+from concurrent.futures import ThreadPoolExecutor
+
+import serial
+
+from utils.serial_frames import SerialDemux
+from utils.sample_history import SampleHistory, MovingAverage
+from utils.serial_recording import SerialRecorder, read_recording
+
+logger = logging.getLogger(__name__)
+
+DEVICE_TYPES = ('serial', 'tcp', 'udp', 'replay')
+DEVICE_ID = re.compile(r'^[A-Za-z0-9_-]+$')  # Vai nas URLs da API
+SERIAL_TIMEOUT_S = 0.1
+CONNECT_TIMEOUT_S = 5
+RECONNECT_MIN_S = 1
+RECONNECT_MAX_S = 30
+
+
+def load_device_config(path, default):
+    """Lê a lista de dispositivos de `path`; sem o arquivo, usa `default`."""
+    try:
+        with open(path, encoding='utf-8') as f:
+            config = json.load(f)
+    except FileNotFoundError:
+        return default
+
+    ids = set()
+    for entry in config:
+        if not DEVICE_ID.match(str(entry.get('id', ''))):
+            raise ValueError(f"Dispositivo com id inválido em {path}: {entry}")
+        if entry['id'] in ids:
+            raise ValueError(f"Id de dispositivo repetido em {path}: {entry['id']}")
+        if entry.get('type', 'serial') not in DEVICE_TYPES:
+            raise ValueError(f"Tipo de dispositivo inválido em {path}: {entry}")
+        if entry.get('type') == 'replay':
+            if float(entry.get('speed', 1)) <= 0:
+                raise ValueError(f"Velocidade de reprodução inválida em {path}: {entry}")
+            # Caminho relativo ao próprio arquivo de configuração
+            entry['file'] = os.path.join(os.path.dirname(os.path.abspath(path)), entry['file'])
+        ids.add(entry['id'])
+    if not config:
+        raise ValueError(f"Nenhum dispositivo em {path}")
+    return config
+
+
+class Device:
+    """Uma fonte de dados e tudo o que é dela: leitor, histórico e estado"""
+
+    def __init__(self, config, history_size, smoothing_window):
+        self.id = config['id']
+        self.kind = config.get('type', 'serial')
+        self.config = config
+        self.demux = SerialDemux()
+        self.history = SampleHistory(history_size)
+        self.smoothing = MovingAverage(smoothing_window)
+        self.latest = None
+        self.recorder = None
+        self._recorder_lock = threading.Lock()
+        self.status = {
+            "connected": False,
+            "last_error": "Inicializando...",
+            "connects": 0,     # Conexões bem-sucedidas
+            "failures": 0,     # Tentativas que falharam ou conexões que caíram
+            "bytes": 0,
+            "last_data": None  # Tempo Unix da última leitura
+        }
+
+    @property
+    def address(self):
+        if self.kind == 'serial':
+            return self.config['port']
+        if self.kind == 'replay':
+            return f"{self.config['file']} ({float(self.config.get('speed', 1)):g}x)"
+        return f"{self.config.get('host', '0.0.0.0')}:{self.config['port']}"
+
+    @property
+    def recording(self):
+        recorder = self.recorder
+        return os.path.basename(recorder.path) if recorder else None
+
+    def describe(self):
+        return {"id": self.id, "type": self.kind, "address": self.address,
+                "status": self.status, "latest": self.latest, "recording": self.recording}
+
+    def start_recording(self, directory):
+        """Começa a gravar o que chega em um arquivo novo; retorna o nome dele."""
+        os.makedirs(directory, exist_ok=True)
+        path = os.path.join(directory, f"{self.id}-{time.strftime('%Y%m%d-%H%M%S')}.srec")
+        with self._recorder_lock:
+            if self.recorder:
+                self.recorder.close()
+            self.recorder = SerialRecorder(path)
+        return os.path.basename(path)
+
+    def stop_recording(self):
+        with self._recorder_lock:
+            if self.recorder:
+                self.recorder.close()
+                self.recorder = None
+
+    def record(self, raw):
+        if self.recorder is None:
+            return
+        with self._recorder_lock:
+            if self.recorder:
+                self.recorder.write(raw)
+
+
+class _Datagrams(asyncio.DatagramProtocol):
+    def __init__(self, on_datagram):
+        self.on_datagram = on_datagram
+        self.closed = asyncio.get_running_loop().create_future()
+
+    def datagram_received(self, data, addr):
+        self.on_datagram(data)
+
+    def error_received(self, exc):
+        if not self.closed.done():
+            self.closed.set_exception(exc)
+
+    def connection_lost(self, exc):
+        if not self.closed.done():
+            self.closed.set_result(None)
+
+
+def _read_available(ser):
+    """Espera até SERIAL_TIMEOUT_S pelo primeiro byte e leva o que já chegou."""
+    data = ser.read(1)
+    if data and ser.in_waiting:
+        data += ser.read(ser.in_waiting)
+    return data
+
+
+class DeviceIngest:
+    """
+    Lê todos os dispositivos em paralelo. on_data(device, raw, text, frames) é
+    chamada a cada leitura; on_status(device), a cada conexão ou falha.
+    """
+
+    def __init__(self, devices, on_data, on_status=None, baud_rate=115200):
+        self.devices = devices
+        self.on_data = on_data
+        self.on_status = on_status
+        self.baud_rate = baud_rate
+        self._thread = None
+        self._loop = None
+        self._stop = None
+        serial_count = sum(1 for device in devices if device.kind == 'serial')
+        self._pool = ThreadPoolExecutor(max_workers=max(1, serial_count), thread_name_prefix='serial')
+
+    @property
+    def running(self):
+        return self._thread is not None and self._thread.is_alive()
+
+    def start(self):
+        if self.running:
+            return
+        # Laço e evento de parada criados aqui, para stop() valer mesmo antes do laço começar
+        self._loop = asyncio.new_event_loop()
+        self._stop = asyncio.Event()
+        self._thread = threading.Thread(target=self._serve, name='device_ingest')
+        self._thread.daemon = True
+        self._thread.start()
+
+    def stop(self, timeout=2):
+        if not self.running:
+            return
+        self._loop.call_soon_threadsafe(self._stop.set)
+        self._thread.join(timeout)
+
+    def _serve(self):
+        try:
+            self._loop.run_until_complete(self._main())
+        finally:
+            self._loop.close()
+
+    async def _main(self):
+        tasks = [asyncio.create_task(self._run(device)) for device in self.devices]
+        await self._stop.wait()
+        for task in tasks:
+            task.cancel()
+        await asyncio.gather(*tasks, return_exceptions=True)
+
+    async def _run(self, device):
+        """Mantém um dispositivo conectado, reabrindo com espera crescente."""
+        readers = {'serial': self._read_serial, 'tcp': self._read_tcp, 'udp': self._read_udp,
+                   'replay': self._read_replay}
+        delay = RECONNECT_MIN_S
+        while True:
+            connects = device.status["connects"]
+            try:
+                await readers[device.kind](device)
+                error = "Conexão encerrada pelo dispositivo"
+            except asyncio.CancelledError:
+                raise
+            except Exception as e:
+                error = f"{device.address}: {e}"
+
+            if device.status["connects"] > connects:
+                delay = RECONNECT_MIN_S  # Chegou a conectar: recomeça a espera
+            device.status["connected"] = False
+            device.status["last_error"] = error
+            device.status["failures"] += 1
+            logger.error(f"Dispositivo {device.id}: {error}; nova tentativa em {delay} s")
+            self._notify(device)
+            await asyncio.sleep(delay)
+            delay = min(delay * 2, RECONNECT_MAX_S)
+
+    def _connected(self, device):
+        device.status["connected"] = True
+        device.status["last_error"] = ""
+        device.status["connects"] += 1
+        logger.info(f"Dispositivo {device.id} conectado em {device.address}")
+        self._notify(device)
+
+    def _notify(self, device):
+        if self.on_status:
+            try:
+                self.on_status(device)
+            except Exception:
+                logger.exception(f"Erro ao tratar o estado do dispositivo {device.id}")
+
+    def _received(self, device, raw):
+        device.status["bytes"] += len(raw)
+        device.status["last_data"] = time.time()
+        device.record(raw)
+        text, frames = device.demux.feed(raw)
+        try:
+            self.on_data(device, raw, text, frames)
+        except Exception:
+            # Um erro ao tratar os dados não derruba a conexão
+            logger.exception(f"Erro ao tratar os dados do dispositivo {device.id}")
+
+    async def _read_serial(self, device):
+        loop = asyncio.get_running_loop()
+        ser = await loop.run_in_executor(
+            self._pool, lambda: serial.Serial(device.config['port'], device.config.get('baud', self.baud_rate),
+                                              timeout=SERIAL_TIMEOUT_S))
+        try:
+            self._connected(device)
+            while True:
+                raw = await loop.run_in_executor(self._pool, _read_available, ser)
+                if raw:
+                    self._received(device, raw)
+        finally:
+            ser.close()
+
+    async def _read_tcp(self, device):
+        reader, writer = await asyncio.wait_for(
+            asyncio.open_connection(device.config['host'], device.config['port']), CONNECT_TIMEOUT_S)
+        try:
+            self._connected(device)
+            while True:
+                raw = await reader.read(4096)
+                if not raw:
+                    return
+                self._received(device, raw)
+        finally:
+            writer.close()
+
+    async def _read_udp(self, device):
+        loop = asyncio.get_running_loop()
+        transport, protocol = await loop.create_datagram_endpoint(
+            lambda: _Datagrams(lambda raw: self._received(device, raw)),
+            local_addr=(device.config.get('host', '0.0.0.0'), device.config['port']))
+        try:
+            self._connected(device)
+            await protocol.closed
+        finally:
+            transport.close()
+
+    async def _read_replay(self, device):
+        loop = asyncio.get_running_loop()
+        speed = float(device.config.get('speed', 1))
+        self._connected(device)
+        while True:
+            start = loop.time()
+            for t, raw in read_recording(device.config['file']):
+                delay = start + t / speed - loop.time()
+                # Mesmo atrasada, a reprodução cede a vez às outras fontes
+                await asyncio.sleep(max(delay, 0))
+                self._received(device, raw)
+            if not device.config.get('loop', False):
+                break
+
+        # Fim da gravação: fica parado em vez de reabrir
+        device.status["connected"] = False
+        device.status["last_error"] = "Reprodução concluída"
+        self._notify(device)
+        await asyncio.Event().wait()
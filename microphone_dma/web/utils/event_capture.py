@@ -0,0 +1,105 @@
+"""
+Montagem dos eventos sonoros enviados pelo gravador com pré-gatilho do firmware.
+
+O microcontrolador envia cada evento em linhas de texto:
+    EVT:BEGIN <id> <taxa_hz> <amostras_pre> <amostras_total> <pico> <tempo_us>
+    EVT:DATA <posicao> <amostras em hexadecimal, 3 dígitos cada>
+    EVT:END <id>
+
+Os eventos completos são salvos como arquivos WAV (16 bits, mono).
+"""
+import os
+import time
+import wave
+import array
+import logging
+import threading
+from collections import deque
+
+logger = logging.getLogger(__name__)
+
+
+class EventAssembler:
+    """Reconstrói os eventos a partir das linhas EVT: e grava os arquivos WAV"""
+
+    def __init__(self, output_dir, max_events=20):
+        self.output_dir = output_dir
+        self.events = deque(maxlen=max_events)  # Metadados dos últimos eventos salvos
+        self._lock = threading.Lock()
+        self._current = None
+
+    def feed_line(self, line):
+        """Processa uma linha que começa com 'EVT:'. Retorna o evento salvo, se houver."""
+        parts = line[4:].split()
+        if not parts:
+            return None
+
+        kind = parts[0]
+        try:
+            if kind == 'BEGIN' and len(parts) >= 7:
+                total = int(parts[4])
+                self._current = {
+                    "id": int(parts[1]),
+                    "rate": int(parts[2]),
+                    "pre_samples": int(parts[3]),
+                    "total_samples": total,
+                    "peak": int(parts[5]),
+                    "device_time_us": int(parts[6]),
+                    "samples": array.array('h', bytes(2 * total)),
+                    "received": 0,
+                }
+            elif kind == 'DATA' and len(parts) >= 3 and self._current:
+                self._store_data(int(parts[1]), parts[2])
+            elif kind == 'END' and self._current:
+                return self._finish()
+        except ValueError as e:
+            logger.warning(f"Linha de evento inválida: '{line}' - {e}")
+        return None
+
+    def _store_data(self, position, hex_data):
+        event = self._current
+        samples = event["samples"]
+        count = len(hex_data) // 3
+        if position < 0 or position + count > len(samples):
+            return
+
+        for i in range(count):
+            raw = int(hex_data[3 * i:3 * i + 3], 16)
+            samples[position + i] = (raw - 2048) * 16  # 12 bits com offset -> 16 bits com sinal
+        event["received"] += count
+
+    def _finish(self):
+        event, self._current = self._current, None
+        if event["received"] != event["total_samples"]:
+            logger.warning(f"Evento {event['id']} incompleto: "
+                           f"{event['received']}/{event['total_samples']} amostras")
+            return None
+
+        os.makedirs(self.output_dir, exist_ok=True)
+        received_at = time.time()
+        filename = f"evento_{time.strftime('%Y%m%d_%H%M%S', time.localtime(received_at))}_{event['id']}.wav"
+
+        with wave.open(os.path.join(self.output_dir, filename), 'wb') as wav:
+            wav.setnchannels(1)
+            wav.setsampwidth(2)
+            wav.setframerate(event["rate"])
+            wav.writeframes(event["samples"].tobytes())
+
+        info = {
+            "id": event["id"],
+            "file": filename,
+            "timestamp": received_at,
+            "rate": event["rate"],
+            "duration_ms": 1000.0 * event["total_samples"] / event["rate"],
+            "pre_trigger_ms": 1000.0 * event["pre_samples"] / event["rate"],
+            "peak": event["peak"],
+            "device_time_us": event["device_time_us"],
+        }
+        with self._lock:
+            self.events.append(info)
+        logger.info(f"Evento sonoro salvo: {filename}")
+        return info
+
+    def list_events(self):
+        with self._lock:
+            return list(self.events)
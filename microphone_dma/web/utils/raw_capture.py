@@ -0,0 +1,74 @@
+"""
+Captura dos bytes brutos recebidos, para o diagnóstico.
+
+As leituras são copiadas como estão para um bytearray circular de tamanho
+fixo; de cada uma guarda-se só o tempo e a posição do fim. Nada é formatado
+na leitura: o hexadecimal e o texto decodificado são montados apenas quando
+alguém pede o diagnóstico (snapshot), e só para as leituras que ainda estão
+inteiras no buffer.
+"""
+import threading
+from array import array
+
+
+class RawCapture:
+    """Últimas `max_chunks` leituras, até `capacity` bytes no total"""
+
+    def __init__(self, capacity=256 * 1024, max_chunks=100, enabled=True):
+        self.enabled = enabled
+        self.capacity = capacity
+        self.max_chunks = max_chunks
+        self._data = bytearray(capacity)
+        self._times = array('d', bytes(8 * max_chunks))
+        self._ends = array('q', bytes(8 * max_chunks))  # Posição absoluta do fim de cada leitura
+        self._sizes = array('l', bytes(array('l').itemsize * max_chunks))
+        self._next = 0      # Próxima entrada de _times/_ends/_sizes
+        self._count = 0
+        self._total = 0     # Bytes já escritos desde o início
+        self._lock = threading.Lock()
+
+    def append(self, timestamp, raw):
+        """Copia uma leitura para o buffer (nada é formatado aqui)."""
+        if not self.enabled:
+            return
+        with self._lock:
+            raw = raw[-self.capacity:]  # Uma leitura maior que o buffer fica só com o fim
+            size = len(raw)
+            pos = self._total % self.capacity
+            first = min(size, self.capacity - pos)
+            self._data[pos:pos + first] = raw[:first]
+            if first < size:
+                self._data[:size - first] = raw[first:]
+            self._total += size
+
+            i = self._next
+            self._times[i] = timestamp
+            self._ends[i] = self._total
+            self._sizes[i] = size
+            self._next = (i + 1) % self.max_chunks
+            if self._count < self.max_chunks:
+                self._count += 1
+
+    def clear(self):
+        with self._lock:
+            self._count = 0
+
+    def snapshot(self):
+        """Leituras guardadas, da mais antiga à mais nova, já formatadas."""
+        with self._lock:
+            entries = []
+            oldest = self._total - self.capacity  # Antes disso já foi sobrescrito
+            for k in range(self._count):
+                i = (self._next - self._count + k) % self.max_chunks
+                end, size = self._ends[i], self._sizes[i]
+                if end - size < oldest:
+                    continue
+                start = (end - size) % self.capacity
+                if start + size <= self.capacity:
+                    raw = bytes(self._data[start:start + size])
+                else:
+                    raw = bytes(self._data[start:]) + bytes(self._data[:start + size - self.capacity])
+                entries.append((self._times[i], raw))
+
+        return [{"time": t, "data_hex": raw.hex(' '), "data_str": raw.decode('utf-8', errors='replace')}
+                for t, raw in entries]
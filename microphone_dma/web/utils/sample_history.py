@@ -0,0 +1,97 @@
+"""
+Histórico recente dos pontos do medidor em buffers circulares numéricos.
+
+Cada campo (seq, timestamp, intensity, value, raw_value) fica em um
+array.array alocado uma vez com a capacidade total; um ponto novo só
+sobrescreve a posição mais antiga. Uma janela é lida por fatias de
+memoryview convertidas de uma vez (tolist, em C), no máximo duas por campo
+quando a janela passa pelo fim do buffer, sem montar um dicionário por ponto.
+"""
+import threading
+from array import array
+
+# Campo e tipo do array ('q' inteiro de 64 bits, 'd' double, 'i' inteiro)
+FIELDS = (('seq', 'q'), ('timestamp', 'd'), ('intensity', 'i'), ('value', 'd'), ('raw_value', 'd'))
+
+
+class SampleHistory:
+    """Últimos `capacity` pontos, numerados em sequência a partir de 1"""
+
+    def __init__(self, capacity):
+        self.capacity = capacity
+        self._columns = {name: array(code, bytes(array(code).itemsize * capacity)) for name, code in FIELDS}
+        self._views = {name: memoryview(column) for name, column in self._columns.items()}
+        self._lock = threading.Lock()
+        self._next = 0        # Posição do próximo ponto
+        self._size = 0
+        self.last_seq = 0
+
+    def __len__(self):
+        return self._size
+
+    def append(self, timestamp, intensity, value, raw_value):
+        """Guarda um ponto e retorna o número de sequência dele."""
+        with self._lock:
+            self.last_seq += 1
+            i = self._next
+            columns = self._columns
+            columns['seq'][i] = self.last_seq
+            columns['timestamp'][i] = timestamp
+            columns['intensity'][i] = intensity
+            columns['value'][i] = value
+            columns['raw_value'][i] = raw_value
+            self._next = (i + 1) % self.capacity
+            if self._size < self.capacity:
+                self._size += 1
+            return self.last_seq
+
+    def clear(self):
+        """Esvazia o histórico; a numeração continua de onde estava."""
+        with self._lock:
+            self._next = 0
+            self._size = 0
+
+    def window(self, after_seq=0, last=None):
+        """
+        Pontos com seq maior que `after_seq` (limitados aos `last` mais novos),
+        do mais antigo ao mais novo, como um dicionário campo -> lista.
+        """
+        with self._lock:
+            count = self._size
+            if after_seq > 0:
+                count = min(count, max(0, self.last_seq - after_seq))
+            if last is not None:
+                count = min(count, last)
+
+            start = (self._next - count) % self.capacity
+            end = start + count
+            wrap = max(0, end - self.capacity)
+            end -= wrap
+            return {name: view[start:end].tolist() + view[:wrap].tolist() if wrap else view[start:end].tolist()
+                    for name, view in self._views.items()}
+
+
+class MovingAverage:
+    """Média dos últimos `size` valores com soma corrente: O(1) por valor"""
+
+    def __init__(self, size):
+        self._values = array('d', bytes(array('d').itemsize * size))
+        self._next = 0
+        self._count = 0
+        self._sum = 0.0
+
+    def add(self, value):
+        """Acrescenta um valor e retorna a média atual."""
+        values = self._values
+        i = self._next
+        if self._count == len(values):
+            self._sum -= values[i]
+        else:
+            self._count += 1
+        values[i] = value
+        self._sum += value
+        self._next = (i + 1) % len(values)
+        if self._next == 0:
+            # Refaz a soma a cada volta, para o erro de arredondamento não acumular
+            self._sum = sum(values[:self._count])
+        return self._sum / self._count
@@ -0,0 +1,86 @@
+"""
+Separação do fluxo serial do firmware em texto e quadros binários.
+
+Além das linhas de texto, o microcontrolador envia as colunas do espectrograma
+como quadros binários (ver spectrogram.h):
+    STX (0x02) | tipo | seq | n | n bytes | soma de 8 bits de tipo, seq, n e dados
+
+Texto nunca contém STX. Um quadro com a soma errada é descartado até o fim
+da linha seguinte (ou até o próximo STX): perde-se no máximo essa linha, e o
+leitor volta a se alinhar sozinho.
+"""
+from collections import namedtuple
+
+FRAME_START = 0x02
+FRAME_HEADER = 4  # STX, tipo, seq, n
+
+Frame = namedtuple('Frame', ['kind', 'seq', 'payload'])
+
+
+class SerialDemux:
+    """Recebe os bytes lidos da serial e devolve o texto já terminado e os quadros válidos"""
+
+    def __init__(self):
+        self._buffer = bytearray()
+        self.bad_frames = 0
+        self._skipping = False  # Descartando o resto de um quadro inválido
+
+    def feed(self, data):
+        """
+        Processa os bytes novos. Retorna (texto, quadros): o texto (bytes) só
+        tem linhas completas, para ser interpretado de uma vez (ver serial_lines).
+        O resto de uma linha interrompida fica guardado para a próxima leitura.
+        """
+        self._buffer += data
+        text = []
+        frames = []
+        buf = self._buffer
+        pos = 0
+
+        while pos < len(buf):
+            if self._skipping:
+                newline = buf.find(b'\n', pos)
+                start = buf.find(FRAME_START, pos)
+                if start >= 0 and (newline < 0 or start < newline):
+                    pos = start
+                elif newline >= 0:
+                    pos = newline + 1
+                else:
+                    pos = len(buf)
+                    break
+                self._skipping = False
+                continue
+
+            start = buf.find(FRAME_START, pos)
+            text_end = len(buf) if start < 0 else start
+
+            # Texto até o próximo quadro: só as linhas já terminadas (\n ou \r)
+            newline = max(buf.rfind(b'\n', pos, text_end), buf.rfind(b'\r', pos, text_end))
+            if newline >= 0:
+                text.append(bytes(buf[pos:newline + 1]))
+                pos = newline + 1
+            if start < 0:
+                break
+            if pos < start:
+                # Linha interrompida por um quadro: o firmware só envia quadros
+                # entre linhas, então o trecho é ruído e é descartado
+                pos = start
+
+            if len(buf) - start < FRAME_HEADER:
+                break
+            size = buf[start + 3]
+            end = start + FRAME_HEADER + size + 1
+            if len(buf) < end:
+                break
+
+            checksum = sum(buf[start + 1:end - 1]) & 0xFF
+            if checksum == buf[end - 1]:
+                frames.append(Frame(chr(buf[start + 1]), buf[start + 2], bytes(buf[start + FRAME_HEADER:end - 1])))
+                pos = end
+            else:
+                self.bad_frames += 1
+                self._skipping = True
+                pos = start + 1
+
+        del buf[:pos]
+        return b''.join(text), frames
@@ -0,0 +1,32 @@
+"""
+Interpretação em bloco das linhas de texto do firmware.
+
+O SerialDemux entrega todo o texto completo de uma leitura de uma vez; aqui
+as expressões regulares compiladas percorrem esse bloco inteiro (em C, dentro
+do módulo re) em vez de o Python olhar linha por linha:
+    "<intensidade> <valor>"   pontos do medidor (printf "%d %.4f")
+    "ETIQUETA: ..."           BEAT, PITCH, SOUND, LEQ, EVT, ... (DEBUG é descartado)
+
+Aceita fim de linha \\r\\n, \\n ou só \\r, e espaços extras entre os números, como
+nas gravações do firmware antigo (serial_raw.txt, "%2d %8.4f\\r"). Linhas fora
+desses formatos são ignoradas.
+"""
+import re
+
+METER_LINE = re.compile(rb'^[ \t]*(\d+)[ \t]+(-?\d+(?:\.\d+)?)[ \t]*$', re.MULTILINE)
+TAGGED_LINE = re.compile(rb'^(?!DEBUG:)[A-Z]+:.*$', re.MULTILINE)
+
+
+def parse_lines(text):
+    """
+    Interpreta um bloco de linhas completas (bytes).
+    Retorna (pontos, linhas_com_etiqueta): pontos é uma lista de
+    (intensidade, valor) e as linhas com etiqueta vêm como str, na ordem.
+    """
+    if not text:
+        return [], []
+    # Para ^ e $ todo fim de linha vira \n (sobram linhas vazias, que não casam)
+    text = text.replace(b'\r', b'\n')
+    points = [(int(i), float(v)) for i, v in METER_LINE.findall(text)]
+    tagged = [line.decode('utf-8', errors='replace') for line in TAGGED_LINE.findall(text)]
+    return points, tagged
@@ -0,0 +1,63 @@
+"""
+Gravação dos bytes recebidos de um dispositivo, para reproduzir depois sem o
+hardware (testes de carga e de regressão).
+
+Formato do arquivo: b'SREC\\x01' seguido de um registro por leitura:
+    tempo desde o início da gravação (double, s) | tamanho (uint32) | bytes
+tudo em little-endian. Um registro incompleto no fim (gravação interrompida)
+é ignorado.
+
+Arquivos sem o cabeçalho, como o serial_raw.txt do monitor_serial.py, também
+podem ser reproduzidos: os bytes são entregues em pedaços na velocidade da
+serial (115200 bauds, cerca de 11520 bytes por segundo).
+"""
+import struct
+import time
+
+MAGIC = b'SREC\x01'
+RECORD = struct.Struct('<dI')
+RAW_BYTES_PER_S = 11520   # 115200 bauds, 10 bits por byte
+RAW_CHUNK = 256
+
+
+class SerialRecorder:
+    """Grava as leituras de uma fonte em `path`"""
+
+    def __init__(self, path):
+        self.path = path
+        self._file = open(path, 'wb')
+        self._file.write(MAGIC)
+        self._start = None
+        self.bytes = 0
+
+    def write(self, raw, timestamp=None):
+        timestamp = time.time() if timestamp is None else timestamp
+        if self._start is None:
+            self._start = timestamp
+        self._file.write(RECORD.pack(timestamp - self._start, len(raw)))
+        self._file.write(raw)
+        self.bytes += len(raw)
+
+    def close(self):
+        self._file.close()
+
+
+def read_recording(path):
+    """Leituras gravadas em `path`, como (segundos desde o início, bytes)."""
+    with open(path, 'rb') as f:
+        data = f.read()
+
+    if not data.startswith(MAGIC):
+        # Bytes sem tempo: pedaços na velocidade da serial
+        for pos in range(0, len(data), RAW_CHUNK):
+            yield pos / RAW_BYTES_PER_S, data[pos:pos + RAW_CHUNK]
+        return
+
+    pos = len(MAGIC)
+    while pos + RECORD.size <= len(data):
+        t, size = RECORD.unpack_from(data, pos)
+        pos += RECORD.size
+        if pos + size > len(data):
+            break
+        yield t, data[pos:pos + size]
+        pos += size
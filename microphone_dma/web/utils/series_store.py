@@ -0,0 +1,165 @@
+"""
+Armazenamento em disco dos pontos do medidor, com agregados por segundo e
+por minuto.
+
+Tudo é gravado só no fim de arquivos binários de registros de tamanho fixo
+(little-endian), um arquivo por segmento de tempo:
+    raw/<início>.bin   um registro por ponto: tempo, intensidade, valor, valor bruto
+    1s/<início>.bin    um registro por segundo: início, contagem, mín, máx, média, p95
+    1m/<início>.bin    o mesmo, por minuto
+<início> é o tempo Unix em segundos do começo do segmento. Os agregados são
+calculados enquanto os pontos chegam (o intervalo em aberto é gravado quando
+chega o primeiro ponto do seguinte), então uma consulta longa lê só o nível
+agregado e nunca os pontos brutos. Como os registros estão em ordem de tempo,
+a consulta acha o começo de cada segmento por busca binária.
+
+Um registro incompleto no fim de um arquivo (queda de energia no meio de uma
+gravação) é ignorado na leitura.
+"""
+import os
+import math
+import struct
+import threading
+from array import array
+
+RAW_RECORD = struct.Struct('<dhff')       # tempo, intensidade, valor, valor bruto
+ROLLUP_RECORD = struct.Struct('<qIffff')  # início, contagem, mín, máx, média, p95
+
+
+class _Tier:
+    """Um nível de armazenamento: segmentos de `segment_s` segundos em `path`"""
+
+    def __init__(self, path, record, segment_s):
+        self.path = path
+        self.record = record
+        self.segment_s = segment_s
+        self._file = None
+        self._segment = None
+        os.makedirs(path, exist_ok=True)
+
+    def append(self, t, values):
+        segment = int(t // self.segment_s) * self.segment_s
+        if segment != self._segment:
+            self.close()
+            self._file = open(os.path.join(self.path, f"{segment}.bin"), 'ab')
+            self._segment = segment
+        self._file.write(self.record.pack(*values))
+
+    def flush(self):
+        if self._file:
+            self._file.flush()
+
+    def close(self):
+        if self._file:
+            self._file.close()
+            self._file = None
+            self._segment = None
+
+    def read(self, start, end):
+        """Registros com tempo em [start, end), em ordem."""
+        size = self.record.size
+        first = int(start // self.segment_s) * self.segment_s
+        segments = sorted(int(name[:-4]) for name in os.listdir(self.path) if name.endswith('.bin'))
+
+        records = []
+        for segment in segments:
+            if segment < first or segment >= end:
+                continue
+            with open(os.path.join(self.path, f"{segment}.bin"), 'rb') as f:
+                data = f.read()
+            data = memoryview(data)[:len(data) - len(data) % size]
+            count = len(data) // size
+            lo = self._bisect(data, count, start)
+            hi = self._bisect(data, count, end)
+            records.extend(self.record.iter_unpack(data[lo * size:hi * size]))
+        return records
+
+    def _bisect(self, data, count, t):
+        """Primeiro registro com tempo >= t (o tempo é o primeiro campo)."""
+        lo, hi = 0, count
+        unpack = self.record.unpack_from
+        size = self.record.size
+        while lo < hi:
+            mid = (lo + hi) // 2
+            if unpack(data, mid * size)[0] < t:
+                lo = mid + 1
+            else:
+                hi = mid
+        return lo
+
+
+class _Rollup:
+    """Agregado do intervalo em aberto de um nível (os valores ficam até ele fechar)"""
+
+    def __init__(self, tier, interval_s):
+        self.tier = tier
+        self.interval_s = interval_s
+        self.start = None
+        self.values = array('f')
+
+    def add(self, t, value):
+        start = int(t // self.interval_s) * self.interval_s
+        if start != self.start:
+            self.close()
+            self.start = start
+        self.values.append(value)
+
+    def close(self):
+        """Grava o intervalo em aberto, se houver."""
+        if not self.values:
+            return
+        ordered = sorted(self.values)
+        count = len(ordered)
+        p95 = ordered[min(count - 1, math.ceil(0.95 * count) - 1)]
+        self.tier.append(self.start, (self.start, count, ordered[0], ordered[-1], sum(ordered) / count, p95))
+        self.tier.flush()
+        self.values = array('f')
+
+
+class SeriesStore:
+    """Pontos brutos e agregados por segundo e por minuto em `directory`"""
+
+    def __init__(self, directory):
+        self._lock = threading.Lock()
+        self._raw = _Tier(os.path.join(directory, 'raw'), RAW_RECORD, 3600)
+        self._rollups = {
+            '1s': _Rollup(_Tier(os.path.join(directory, '1s'), ROLLUP_RECORD, 86400), 1),
+            '1m': _Rollup(_Tier(os.path.join(directory, '1m'), ROLLUP_RECORD, 30 * 86400), 60),
+        }
+
+    def append(self, timestamp, intensity, value, raw_value):
+        """Grava um ponto e atualiza os agregados."""
+        with self._lock:
+            second = self._rollups['1s'].start
+            self._raw.append(timestamp, (timestamp, intensity, value, raw_value))
+            for rollup in self._rollups.values():
+                rollup.add(timestamp, value)
+            if second is not None and int(timestamp) != second:
+                self._raw.flush()  # Os pontos brutos chegam ao disco uma vez por segundo
+
+    def query(self, start, end, resolution):
+        """
+        Pontos em [start, end) como colunas. resolution é 'raw' (t, intensity,
+        value, raw_value) ou '1s'/'1m' (t, count, min, max, mean, p95). Os
+        intervalos ainda em aberto só aparecem depois de fechados.
+        """
+        with self._lock:
+            if resolution == 'raw':
+                self._raw.flush()
+                fields = ('t', 'intensity', 'value', 'raw_value')
+                records = self._raw.read(start, end)
+            else:
+                # Inclui o intervalo que contém `start`
+                rollup = self._rollups[resolution]
+                fields = ('t', 'count', 'min', 'max', 'mean', 'p95')
+                records = rollup.tier.read(start // rollup.interval_s * rollup.interval_s, end)
+
+        columns = zip(*records) if records else [()] * len(fields)
+        return {name: list(column) for name, column in zip(fields, columns)}
+
+    def close(self):
+        with self._lock:
+            for rollup in self._rollups.values():
+                rollup.close()
+                rollup.tier.close()
+            self._raw.close()
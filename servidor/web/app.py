@@ -1,14 +1,19 @@
 import eventlet
 eventlet.monkey_patch()
 
-from flask import Flask, render_template
+from flask import Flask, render_template, jsonify, request
 from flask_socketio import SocketIO, emit
 import serial.tools.list_ports
 from serial import Serial, SerialException
 import threading
-import re
 import time
 import logging
+import argparse
+from collections import deque
+from downsample import downsample_columns
+from serial_recording import SerialRecorder, read_recording
+from serial_protocol import SerialDecoder
+from socket_emitter import CoalescingEmitter
 
 # Configuração de logging para reduzir saída no console
 logging.basicConfig(level=logging.INFO, 
@@ -22,49 +27,25 @@ logging.getLogger('socketio').setLevel(logging.WARNING)
 
 # Criação do aplicativo Flask
 app = Flask(__name__)
-socketio = SocketIO(app, async_mode='eventlet')
+# Os tratadores de eventos são curtos (conexão e confirmação de lote): rodam
+# direto, sem uma tarefa nova por mensagem
+socketio = SocketIO(app, async_mode='eventlet', async_handlers=False)
+
+# Leituras enviadas aos navegadores em lotes ('novos_dados'), no máximo
+# EMIT_RATE_HZ vezes por segundo e com controle de fluxo por cliente
+EMIT_RATE_HZ = 20
+emitter = CoalescingEmitter(socketio, 'novos_dados', EMIT_RATE_HZ)
 
 # Flag para controlar o nível de verbosidade dos logs
 VERBOSE_LOGGING = False
 
-# Função para extrair dados completos da mensagem
-def extract_data_from_serial(data):
-    """Extrai temperatura, limite, status de alerta e contador de alertas da mensagem serial"""
-    try:
-        # Padrão para extrair todos os dados da placa:
-        # Exemplo: "Temperatura: 33.64 C | Limite: 40.0 C | Alerta: Inativo | Alertas: 1"
-        temp_match = re.search(r'Temperatura: ([0-9]+(?:\.[0-9]+)?)', data)
-        limite_match = re.search(r'Limite: ([0-9]+(?:\.[0-9]+)?)', data)
-        alerta_match = re.search(r'Alerta: (\w+)', data)
-        alertas_match = re.search(r'Alertas: ([0-9]+)', data)
-        
-        result = {}
-        
-        if temp_match:
-            result['temperatura'] = float(temp_match.group(1))
-        
-        if limite_match:
-            result['limite'] = float(limite_match.group(1))
-        
-        if alerta_match:
-            result['status_alerta'] = alerta_match.group(1)
-        
-        if alertas_match:
-            result['alertas'] = int(alertas_match.group(1))
-            
-        if 'temperatura' in result:  # Se pelo menos temos a temperatura
-            return result
-            
-        # Fallback: tentar buscar apenas um número para a temperatura
-        if not result:
-            simple_match = re.search(r'([0-9]+(?:\.[0-9]+)?)', data)
-            if simple_match:
-                return {'temperatura': float(simple_match.group(1))}
-                
-        return None
-    except Exception as e:
-        logging.error(f"Erro ao extrair dados: {e}")
-        return None
+# Histórico das leituras (tempo Unix, temperatura, limite) para /api/history
+HISTORY_SIZE = 24 * 3600  # Um dia a uma leitura por segundo
+history = deque(maxlen=HISTORY_SIZE)
+DEFAULT_HISTORY_POINTS = 500
+
+# Gravação dos bytes lidos da serial (--record), para reproduzir com --replay
+recorder = None
 
 # Função para encontrar a porta serial automaticamente
 def find_arduino_port():
@@ -81,6 +62,18 @@ def find_arduino_port():
     
     return None
 
+# Trata as leituras interpretadas pelo SerialDecoder (da serial ou de uma gravação)
+def handle_readings(readings):
+    for parsed_data in readings:
+        if VERBOSE_LOGGING:
+            logging.debug(f"Serial: {parsed_data}")
+        
+        # Tempo Unix da leitura, também enviado ao cliente (o bench_socketio.py mede a latência com ele)
+        parsed_data['t'] = time.time()
+        history.append((parsed_data['t'], parsed_data['temperatura'], parsed_data.get('limite')))
+        # Segue no próximo lote; a leitura da serial não espera pelos navegadores
+        emitter.push(parsed_data)
+
 # Função para ler dados da porta serial
 def read_serial(stop_event=None):
     # Tenta encontrar a porta automaticamente
@@ -97,34 +90,19 @@ def read_serial(stop_event=None):
             with Serial(port, 115200, timeout=1) as ser:
                 logging.info(f"Conectado com sucesso à porta {port}")
                 
-                # Contador para limitar logs
-                read_count = 0
+                # Linhas de texto ou JSON e quadros binários (ver serial_protocol.py)
+                decoder = SerialDecoder()
                 
                 while stop_event is None or not stop_event.is_set():
-                    try:
-                        data = ser.readline().decode('utf-8').strip()
-                        if data:
-                            read_count += 1
-                            
-                            # Log limitado
-                            if VERBOSE_LOGGING or read_count % 10 == 0:
-                                logging.debug(f"Serial: {data}")
-                            
-                            # Extrair todos os dados disponíveis
-                            parsed_data = extract_data_from_serial(data)
-                            if parsed_data:
-                                try:
-                                    # Enviar dados completos para o cliente
-                                    socketio.emit('novo_dado', parsed_data)
-                                except Exception as emitError:
-                                    logging.error(f"Erro ao enviar dados: {emitError}")
-                            elif VERBOSE_LOGGING:
-                                logging.warning(f"Erro ao converter dado: {data}")
-                    except UnicodeDecodeError:
-                        if VERBOSE_LOGGING:
-                            logging.warning("Erro ao decodificar dados da serial")
-                    # Pequena pausa para não sobrecarregar
-                    time.sleep(0.01)  
+                    waiting = ser.in_waiting
+                    if not waiting:
+                        # Pausa só sem dados; uma leitura bloqueante prenderia as outras tarefas
+                        time.sleep(0.01)
+                        continue
+                    raw = ser.read(waiting)
+                    if recorder:
+                        recorder.write(raw)
+                    handle_readings(decoder.feed(raw))
         
         except SerialException as e:
             logging.error(f"Erro na conexão serial: {e}")
@@ -134,30 +112,100 @@ def read_serial(stop_event=None):
             logging.error(f"Erro inesperado: {e}")
             time.sleep(5)
 
+@socketio.on('connect')
+def handle_connect():
+    emitter.add_client(request.sid)
+
+@socketio.on('disconnect')
+def handle_disconnect(reason=None):
+    emitter.remove_client(request.sid)
+
+@socketio.on('confirmar_lote')
+def handle_batch_ack(batch_id):
+    emitter.ack(request.sid, batch_id)
+
 # Rota principal para exibir a interface web
 @app.route('/')
 def index():
     return render_template('index.html')
 
+# Leituras entre ?from= e ?to= (tempo Unix em segundos; padrão: todo o histórico),
+# reduzidas por LTTB a no máximo ?points= pontos, em colunas
+@app.route('/api/history')
+def get_history():
+    start = request.args.get('from', 0.0, type=float)
+    end = request.args.get('to', float('inf'), type=float)
+    points = max(3, request.args.get('points', DEFAULT_HISTORY_POINTS, type=int))
+    
+    rows = [row for row in list(history) if start <= row[0] < end]
+    columns = {"t": [row[0] for row in rows],
+               "temperatura": [row[1] for row in rows],
+               "limite": [row[2] for row in rows]}
+    return jsonify(downsample_columns(columns, 't', 'temperatura', points))
+
+# Reproduz uma gravação (ou bytes copiados da serial) pelo mesmo caminho da
+# leitura real, no ritmo gravado multiplicado por `speed`
+def replay_serial(path, speed=1.0, loop=False, stop_event=None):
+    logging.info(f"Reproduzindo {path} a {speed:g}x")
+    while True:
+        start = time.monotonic()
+        decoder = SerialDecoder()
+        for t, raw in read_recording(path):
+            if stop_event and stop_event.is_set():
+                logging.info("Parando reprodução por solicitação")
+                return
+            delay = start + t / speed - time.monotonic()
+            # Mesmo atrasada, a reprodução cede a vez às outras threads
+            time.sleep(max(delay, 0))
+            handle_readings(decoder.feed(raw))
+        handle_readings(decoder.flush())
+        if not loop:
+            break
+    logging.info("Reprodução concluída")
+
 # Iniciar a thread de leitura serial sem bloquear o servidor web
-def initialize_serial_thread():
+def initialize_serial_thread(replay=None, speed=1.0, loop=False):
     stop_event = threading.Event()
-    serial_thread = threading.Thread(target=read_serial, args=(stop_event,))
+    if replay:
+        serial_thread = threading.Thread(target=replay_serial, args=(replay, speed, loop, stop_event))
+    else:
+        serial_thread = threading.Thread(target=read_serial, args=(stop_event,))
     serial_thread.daemon = True
     serial_thread.start()
     return serial_thread, stop_event
 
 # Função principal
 def main():
+    global recorder
+    
+    parser = argparse.ArgumentParser(description="Monitoramento de temperatura via serial")
+    parser.add_argument('--record', metavar='ARQUIVO', help="grava os bytes lidos da serial em ARQUIVO")
+    parser.add_argument('--replay', metavar='ARQUIVO', help="reproduz ARQUIVO em vez de ler a serial")
+    parser.add_argument('--speed', type=float, default=1.0, help="velocidade da reprodução (padrão: 1)")
+    parser.add_argument('--loop', action='store_true', help="repete a reprodução ao chegar ao fim")
+    parser.add_argument('--emit-rate', type=float, default=EMIT_RATE_HZ,
+                        help=f"lotes por segundo enviados aos navegadores (padrão: {EMIT_RATE_HZ})")
+    parser.add_argument('--host', default='0.0.0.0', help="endereço do servidor web (padrão: 0.0.0.0)")
+    parser.add_argument('--port', type=int, default=5000, help="porta do servidor web (padrão: 5000)")
+    args = parser.parse_args()
+    if args.speed <= 0:
+        parser.error("--speed deve ser maior que zero")
+    if args.emit_rate <= 0:
+        parser.error("--emit-rate deve ser maior que zero")
+    emitter.rate_hz = args.emit_rate
+    if args.record and not args.replay:
+        recorder = SerialRecorder(args.record)
+    
     print("\n=== SISTEMA DE MONITORAMENTO DE TEMPERATURA ===")
-    print("Iniciando servidor web em http://localhost:5000")
+    print(f"Iniciando servidor web em http://localhost:{args.port}")
     print("Pressione Ctrl+C para encerrar\n")
     
-    # Inicia a leitura serial em uma thread separada
-    serial_thread, stop_event = initialize_serial_thread()
+    # Inicia o envio em lotes e a leitura serial em uma thread separada
+    emitter.start()
+    serial_thread, stop_event = initialize_serial_thread(args.replay, args.speed, args.loop)
     
     try:
-        socketio.run(app, host='0.0.0.0', port=5000, debug=False, use_reloader=False)
+        socketio.run(app, host=args.host, port=args.port, debug=False, use_reloader=False)
     except KeyboardInterrupt:
         print("\nEncerrando servidor...")
     except Exception as e:
@@ -167,6 +215,8 @@ def main():
         if stop_event:
             stop_event.set()
             serial_thread.join(timeout=1.0)
+        if recorder:
+            recorder.close()
         print("Servidor encerrado")
 
 if __name__ == "__main__":
@@ -0,0 +1,137 @@
+"""
+Benchmark da interpretação das leituras da serial, em linhas por segundo.
+
+Uso: python bench_serial_protocol.py
+
+Compara a extração antiga (quatro re.search e mais uma de reserva por linha)
+com a nova (serial_protocol.py: uma passada de um só padrão), linha a linha e
+pelo SerialDecoder sobre o fluxo inteiro em pedaços, e mede também os
+formatos JSON e binário. Antes de medir, confere que as duas extrações dão o
+mesmo resultado para as linhas de texto.
+"""
+import re
+import json
+import time
+import random
+
+from serial_protocol import SerialDecoder, encode_frame, extract_data_from_serial
+
+LINES = 20000
+CHUNK = 64     # Bytes por leitura da serial, em média
+ROUNDS = 5
+
+
+def legacy_extract(data):
+    """extract_data_from_serial como era antes do serial_protocol.py"""
+    try:
+        temp_match = re.search(r'Temperatura: ([0-9]+(?:\.[0-9]+)?)', data)
+        limite_match = re.search(r'Limite: ([0-9]+(?:\.[0-9]+)?)', data)
+        alerta_match = re.search(r'Alerta: (\w+)', data)
+        alertas_match = re.search(r'Alertas: ([0-9]+)', data)
+        result = {}
+        if temp_match:
+            result['temperatura'] = float(temp_match.group(1))
+        if limite_match:
+            result['limite'] = float(limite_match.group(1))
+        if alerta_match:
+            result['status_alerta'] = alerta_match.group(1)
+        if alertas_match:
+            result['alertas'] = int(alertas_match.group(1))
+        if 'temperatura' in result:
+            return result
+        if not result:
+            simple_match = re.search(r'([0-9]+(?:\.[0-9]+)?)', data)
+            if simple_match:
+                return {'temperatura': float(simple_match.group(1))}
+        return None
+    except Exception:
+        return None
+
+
+def readings(rng):
+    for i in range(LINES):
+        temperatura = round(rng.uniform(20, 45), 2)
+        yield temperatura, 40.0, temperatura > 40, i // 50
+
+
+def text_stream(rng):
+    return ''.join(f"Temperatura: {t:.2f} C | Limite: {l:.1f} C | Alerta: {'Ativo' if a else 'Inativo'} | Alertas: {n}\r\n"
+                   for t, l, a, n in readings(rng)).encode()
+
+
+def json_stream(rng):
+    return ''.join(json.dumps({"temp": t, "lim": l, "alerta": int(a), "alertas": n}, separators=(',', ':')) + '\n'
+                   for t, l, a, n in readings(rng)).encode()
+
+
+def binary_stream(rng):
+    return b''.join(encode_frame(*reading) for reading in readings(rng))
+
+
+def chunks(data, rng):
+    pos = 0
+    while pos < len(data):
+        size = rng.randint(1, 2 * CHUNK)
+        yield data[pos:pos + size]
+        pos += size
+
+
+def best_time(fn, arg):
+    best = None
+    for _ in range(ROUNDS):
+        t0 = time.perf_counter()
+        count = fn(arg)
+        dt = time.perf_counter() - t0
+        best = dt if best is None else min(best, dt)
+    assert count == LINES, f"{count} leituras em vez de {LINES}"
+    return best
+
+
+def per_line(extract):
+    def run(lines):
+        return sum(1 for line in lines if extract(line))
+    return run
+
+
+def legacy_stream(pieces):
+    """Caminho antigo: linha a linha (como o readline), decode e extração antiga"""
+    count = 0
+    pending = b''
+    for raw in pieces:
+        lines = (pending + raw).split(b'\n')
+        pending = lines.pop()
+        for line in lines:
+            data = line.decode('utf-8').strip()
+            if data and legacy_extract(data):
+                count += 1
+    return count
+
+
+def decoder(pieces):
+    dec = SerialDecoder()
+    return sum(len(dec.feed(raw)) for raw in pieces)
+
+
+def main():
+    text = text_stream(random.Random(1))
+    lines = text.decode().splitlines()
+    for line in lines:
+        assert legacy_extract(line) == extract_data_from_serial(line), line
+
+    print(f"{LINES} leituras, {CHUNK} bytes por leitura da serial em média")
+    print(f"{'interpretação':<40} {'linhas/s':>12}")
+    text_pieces = list(chunks(text, random.Random(2)))
+    cases = [
+        ("texto, extração antiga (5 regex)", per_line(legacy_extract), lines),
+        ("texto, extração nova (1 padrão)", per_line(extract_data_from_serial), lines),
+        ("texto, leitura antiga (linha a linha)", legacy_stream, text_pieces),
+        ("texto, SerialDecoder", decoder, text_pieces),
+        ("JSON, SerialDecoder", decoder, list(chunks(json_stream(random.Random(1)), random.Random(2)))),
+        ("binário, SerialDecoder", decoder, list(chunks(binary_stream(random.Random(1)), random.Random(2)))),
+    ]
+    for name, fn, arg in cases:
+        print(f"{name:<40} {LINES / best_time(fn, arg):12.0f}")
+
+
+if __name__ == '__main__':
+    main()
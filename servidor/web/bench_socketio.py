@@ -0,0 +1,217 @@
+"""
+Benchmark da entrega das leituras ('novos_dados') a vários navegadores ao mesmo tempo.
+
+Uso: python bench_socketio.py [--clients 1,10,50,100,500] [--duration 10] [--rate 10]
+
+O app.py sobe em outro processo, em uma porta livre, reproduzindo em laço uma
+gravação sintética com `rate` leituras por segundo (--replay, ver
+serial_recording.py): nada de hardware nem de serviços externos, e a mesma
+carga a cada execução. Os clientes são corrotinas asyncio que falam
+Socket.IO sobre WebSocket escrito à mão e confirmam cada lote, como o
+navegador. A latência de cada leitura é a hora de chegada menos o campo 't'
+dela (hora da leitura no servidor; os dois processos usam o mesmo relógio),
+e inclui a espera pelo próximo lote. Contam só as leituras feitas durante a
+medida, depois de todos os clientes conectados. Para cada número de
+clientes, mostra a fração dos eventos esperados que chegou e a latência p50
+e p99.
+
+O servidor roda como o app.py manda (eventlet): sem o eventlet instalado ele
+nem sobe, e um resultado medido em outro modo (threading) não vale para ele.
+"""
+import os
+import sys
+import json
+import time
+import base64
+import socket
+import struct
+import asyncio
+import argparse
+import platform
+import tempfile
+import subprocess
+
+from serial_recording import SerialRecorder
+
+WEB_DIR = os.path.dirname(os.path.abspath(__file__))
+DEFAULT_CLIENTS = '1,10,50,100,500'
+RECORDING_S = 60          # Reproduzida em laço
+CONNECT_CONCURRENCY = 50  # Conexões abertas ao mesmo tempo, para não estourar a fila do servidor
+STARTUP_TIMEOUT_S = 15
+GRACE_S = 2               # Espera pelos eventos ainda a caminho no fim da medida
+
+
+def write_recording(path, rate):
+    """Gravação com linhas no formato do Pico W, `rate` por segundo."""
+    recorder = SerialRecorder(path)
+    for i in range(int(rate * RECORDING_S)):
+        temperatura = 30 + (i % 100) / 10
+        alerta = 'Ativo' if temperatura > 38 else 'Inativo'
+        recorder.write(f"Temperatura: {temperatura:.2f} C | Limite: 38.0 C | Alerta: {alerta} | Alertas: {i // 100}\r\n"
+                       .encode(), i / rate)
+    recorder.close()
+
+
+def free_port():
+    with socket.socket() as s:
+        s.bind(('127.0.0.1', 0))
+        return s.getsockname()[1]
+
+
+def start_server(tmp, port, rate):
+    recording = os.path.join(tmp, 'bench.srec')
+    write_recording(recording, rate)
+    return subprocess.Popen([sys.executable, 'app.py', '--replay', recording, '--loop',
+                             '--host', '127.0.0.1', '--port', str(port)],
+                            cwd=WEB_DIR, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+
+
+class SocketIOClient:
+    """Cliente Socket.IO mínimo: WebSocket (RFC 6455) com Engine.IO 4"""
+
+    def __init__(self, reader, writer):
+        self.reader = reader
+        self.writer = writer
+
+    @classmethod
+    async def connect(cls, port):
+        reader, writer = await asyncio.open_connection('127.0.0.1', port)
+        key = base64.b64encode(os.urandom(16)).decode()
+        writer.write(f"GET /socket.io/?EIO=4&transport=websocket HTTP/1.1\r\n"
+                     f"Host: 127.0.0.1:{port}\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                     f"Sec-WebSocket-Key: {key}\r\nSec-WebSocket-Version: 13\r\n\r\n".encode())
+        head = await reader.readuntil(b'\r\n\r\n')
+        if b' 101 ' not in head.split(b'\r\n', 1)[0]:
+            writer.close()
+            raise ConnectionError(head.split(b'\r\n', 1)[0].decode(errors='replace'))
+
+        client = cls(reader, writer)
+        if not (await client.receive()).startswith('0'):  # Abertura do Engine.IO
+            raise ConnectionError("Handshake do Engine.IO inesperado")
+        client.send('40')                                  # Entra no namespace '/'
+        while not (await client.receive()).startswith('40'):
+            pass
+        return client
+
+    def send(self, text):
+        payload = text.encode()
+        mask = os.urandom(4)
+        if len(payload) < 126:
+            header = struct.pack('!BB', 0x81, 0x80 | len(payload))
+        else:
+            header = struct.pack('!BBH', 0x81, 0x80 | 126, len(payload))
+        masked = bytes(b ^ mask[i % 4] for i, b in enumerate(payload))
+        self.writer.write(header + mask + masked)
+
+    async def receive(self):
+        """Próxima mensagem de texto (responde aos pings do Engine.IO e do WebSocket)."""
+        while True:
+            b0, b1 = await self.reader.readexactly(2)
+            size = b1 & 0x7f
+            if size == 126:
+                size, = struct.unpack('!H', await self.reader.readexactly(2))
+            elif size == 127:
+                size, = struct.unpack('!Q', await self.reader.readexactly(8))
+            payload = await self.reader.readexactly(size)
+            opcode = b0 & 0x0f
+            if opcode == 0x8:
+                raise ConnectionError("WebSocket fechado pelo servidor")
+            if opcode == 0x9:
+                self.writer.write(struct.pack('!BB', 0x8a, 0x80) + os.urandom(4))  # Pong sem dados
+                continue
+            text = payload.decode()
+            if text == '2':
+                self.send('3')
+                continue
+            return text
+
+    async def listen(self, latencies, start, end):
+        """Latência das leituras feitas entre `start` e `end`."""
+        while True:
+            message = await self.receive()
+            if not message.startswith('42'):
+                continue
+            event, *args = json.loads(message[2:])
+            if event != 'novos_dados':
+                continue
+            batch_id, readings = args
+            now = time.time()
+            latencies.extend(now - data['t'] for data in readings if start <= data['t'] < end)
+            self.send(f'42["confirmar_lote",{batch_id}]')
+
+    def close(self):
+        self.writer.close()
+
+
+async def wait_ready(port, proc):
+    deadline = time.monotonic() + STARTUP_TIMEOUT_S
+    while time.monotonic() < deadline:
+        if proc.poll() is not None:
+            raise RuntimeError(f"app.py terminou com código {proc.returncode}")
+        try:
+            client = await SocketIOClient.connect(port)
+            client.close()
+            return
+        except (OSError, ConnectionError, asyncio.IncompleteReadError):
+            await asyncio.sleep(0.2)
+    raise RuntimeError("app.py não ficou pronto a tempo")
+
+
+async def run_level(port, clients, duration):
+    limit = asyncio.Semaphore(CONNECT_CONCURRENCY)
+
+    async def connect():
+        async with limit:
+            return await SocketIOClient.connect(port)
+
+    connected = await asyncio.gather(*(connect() for _ in range(clients)))
+    latencies = []
+    start = time.time()
+    tasks = [asyncio.create_task(client.listen(latencies, start, start + duration)) for client in connected]
+    await asyncio.sleep(duration + GRACE_S)
+    for task in tasks:
+        task.cancel()
+    results = await asyncio.gather(*tasks, return_exceptions=True)
+    for client in connected:
+        client.close()
+    errors = sum(1 for r in results if not isinstance(r, asyncio.CancelledError))
+    return latencies, errors
+
+
+def percentile(values, p):
+    return values[min(len(values) - 1, round(p * (len(values) - 1)))] if values else float('nan')
+
+
+async def bench(port, proc, levels, duration, rate):
+    await wait_ready(port, proc)
+    print(f"{'clientes':>8} {'eventos/s':>10} {'entregues':>10} {'p50 ms':>9} {'p99 ms':>9} {'erros':>6}")
+    for clients in levels:
+        latencies, errors = await run_level(port, clients, duration)
+        latencies.sort()
+        expected = clients * rate * duration
+        print(f"{clients:>8} {len(latencies) / duration:10.1f} {100 * len(latencies) / expected:9.1f}% "
+              f"{1e3 * percentile(latencies, 0.5):9.2f} {1e3 * percentile(latencies, 0.99):9.2f} {errors:>6}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument('--clients', default=DEFAULT_CLIENTS, help=f"clientes simultâneos (padrão: {DEFAULT_CLIENTS})")
+    parser.add_argument('--duration', type=float, default=10, help="segundos por medida (padrão: 10)")
+    parser.add_argument('--rate', type=float, default=10, help="leituras por segundo (padrão: 10)")
+    args = parser.parse_args()
+    levels = [int(n) for n in args.clients.split(',')]
+
+    print(f"Python {platform.python_version()}, {os.cpu_count()} CPUs, {args.duration:g} s por medida, "
+          f"{args.rate:g} leituras/s")
+    with tempfile.TemporaryDirectory() as tmp:
+        port = free_port()
+        proc = start_server(tmp, port, args.rate)
+        try:
+            asyncio.run(bench(port, proc, levels, args.duration, args.rate))
+        finally:
+            proc.terminate()
+            proc.wait()
+
+
+if __name__ == '__main__':
+    main()
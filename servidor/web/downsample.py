@@ -0,0 +1,62 @@
+"""
+Redução de séries para os gráficos: Largest-Triangle-Three-Buckets (LTTB).
+
+Escolhe `points` pontos de uma série mantendo o formato da curva: o primeiro
+e o último ficam, e de cada faixa intermediária fica o ponto que forma o
+maior triângulo com o ponto escolhido na faixa anterior e a média da faixa
+seguinte. Picos isolados sobrevivem, ao contrário de uma média por faixa.
+O custo é O(n) e o resultado tem tamanho fixo, por maior que seja a janela.
+
+Este arquivo existe idêntico em microphone_dma/web/utils/downsample.py e em
+servidor/web/downsample.py, porque cada painel roda sozinho, sem o outro no
+caminho: uma correção em um vale para os dois.
+"""
+
+
+def lttb_indices(x, y, points):
+    """Índices (em ordem) dos pontos escolhidos de x/y; todos, se já couberem."""
+    n = len(x)
+    if points >= n or n <= 2:
+        return list(range(n))
+    if points < 3:
+        return [0, n - 1][:max(points, 0)]
+
+    every = (n - 2) / (points - 2)
+    chosen = [0]
+    a = 0
+    for i in range(points - 2):
+        # Média da faixa seguinte (a última faixa usa o último ponto)
+        next_start = int((i + 1) * every) + 1
+        next_end = min(int((i + 2) * every) + 1, n)
+        if next_start >= next_end:
+            next_start, next_end = n - 1, n
+        span = next_end - next_start
+        avg_x = sum(x[next_start:next_end]) / span
+        avg_y = sum(y[next_start:next_end]) / span
+
+        # Ponto da faixa atual com o maior triângulo
+        ax, ay = x[a], y[a]
+        best = start = int(i * every) + 1
+        best_area = -1.0
+        for j in range(start, int((i + 1) * every) + 1):
+            area = abs((ax - avg_x) * (y[j] - ay) - (ax - x[j]) * (avg_y - ay))
+            if area > best_area:
+                best_area = area
+                best = j
+        chosen.append(best)
+        a = best
+
+    chosen.append(n - 1)
+    return chosen
+
+
+def downsample_columns(columns, x_field, y_field, points):
+    """
+    Reduz uma série em colunas ({campo: lista}) a `points` linhas, escolhidas
+    por LTTB sobre x_field/y_field; as outras colunas seguem as mesmas linhas.
+    """
+    x = columns[x_field]
+    if points is None or points >= len(x):
+        return columns
+    chosen = lttb_indices(x, columns[y_field], points)
+    return {name: [column[i] for i in chosen] for name, column in columns.items()}
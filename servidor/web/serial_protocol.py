@@ -0,0 +1,172 @@
+"""
+Interpretação das leituras enviadas pelo Pico W, em três formatos:
+
+- texto, uma linha por leitura (o formato original):
+      Temperatura: 33.64 C | Limite: 40.0 C | Alerta: Inativo | Alertas: 1
+  lido em uma só passada por uma expressão de pares "Chave: valor";
+- JSON, um objeto por linha, com nomes curtos ou completos:
+      {"temp": 33.64, "lim": 40.0, "alerta": 0, "alertas": 1}
+- binário, um quadro de 10 bytes sem fim de linha:
+      A5 5A | temperatura (int16, centésimos de °C) | limite (int16, centésimos)
+            | alerta (uint8, 0 ou 1) | alertas (uint16) | soma dos bytes 2 a 8 (uint8)
+  tudo em little-endian.
+
+Todos viram o mesmo dicionário enviado ao navegador: temperatura, limite,
+status_alerta ("Ativo"/"Inativo") e alertas.
+"""
+import re
+import json
+import struct
+import logging
+
+logger = logging.getLogger(__name__)
+
+# Pares "Chave: valor" de uma linha de texto, todos de uma vez
+TOKEN = re.compile(r'([A-Za-z]+): *([^\s|]+)')
+NUMBER = re.compile(r'[0-9]+(?:\.[0-9]+)?')
+
+TEXT_FIELDS = {
+    'Temperatura': ('temperatura', float),
+    'Limite': ('limite', float),
+    'Alerta': ('status_alerta', str),
+    'Alertas': ('alertas', int),
+}
+JSON_FIELDS = {
+    'temp': 'temperatura', 'temperatura': 'temperatura',
+    'lim': 'limite', 'limite': 'limite',
+    'alerta': 'status_alerta',
+    'alertas': 'alertas',
+}
+
+FRAME_SYNC = b'\xa5\x5a'
+FRAME = struct.Struct('<2shhBHB')
+MAX_LINE = 1024  # Sem fim de linha até aqui, os bytes são descartados
+
+
+def alert_status(value):
+    if isinstance(value, str):
+        return value
+    return 'Ativo' if value else 'Inativo'
+
+
+def extract_data_from_serial(data):
+    """Extrai temperatura, limite, status de alerta e contador de alertas de uma linha"""
+    if data.startswith('{'):
+        return _extract_json(data)
+
+    result = {}
+    for key, value in TOKEN.findall(data):
+        field = TEXT_FIELDS.get(key)
+        if field:
+            try:
+                result[field[0]] = field[1](value)
+            except ValueError:
+                pass
+
+    if 'temperatura' in result:  # Se pelo menos temos a temperatura
+        return result
+
+    # Fallback: uma linha só com um número é a temperatura
+    if not result:
+        match = NUMBER.search(data)
+        if match:
+            return {'temperatura': float(match.group())}
+    return None
+
+
+def _extract_json(data):
+    try:
+        obj = json.loads(data)
+    except ValueError:
+        return None
+    if not isinstance(obj, dict):
+        return None
+
+    result = {}
+    for key, value in obj.items():
+        field = JSON_FIELDS.get(key)
+        if field == 'status_alerta':
+            result[field] = alert_status(value)
+        elif field == 'alertas' and isinstance(value, (int, float)):
+            result[field] = int(value)
+        elif field and isinstance(value, (int, float)):
+            result[field] = float(value)
+    return result if 'temperatura' in result else None
+
+
+def encode_frame(temperatura, limite, alerta, alertas):
+    """Quadro binário de uma leitura (para testes e gravações sintéticas)."""
+    body = FRAME.pack(FRAME_SYNC, round(temperatura * 100), round(limite * 100), int(bool(alerta)), alertas, 0)
+    return body[:-1] + bytes([sum(body[2:-1]) & 0xff])
+
+
+class SerialDecoder:
+    """
+    Separa o fluxo da serial em linhas (texto ou JSON) e quadros binários. O
+    resto de uma linha ou quadro incompleto fica guardado até a próxima leitura.
+    """
+
+    def __init__(self):
+        self._buffer = bytearray()
+        self.rejected = 0  # Linhas não reconhecidas e quadros com soma errada
+
+    def feed(self, raw):
+        """Leituras completas até agora, já interpretadas."""
+        buf = self._buffer
+        buf += raw
+        readings = []
+        pos = 0
+        while True:
+            sync = buf.find(FRAME_SYNC, pos)
+            end = len(buf) if sync == -1 else sync
+            newline = buf.rfind(b'\n', pos, end)
+            if newline != -1:
+                self._lines(buf[pos:newline], readings)
+                pos = newline + 1
+            if sync == -1:
+                break
+            if sync > pos:
+                # Texto sem fim de linha antes de um quadro
+                self._lines(buf[pos:sync], readings)
+            if len(buf) - sync < FRAME.size:
+                pos = sync
+                break
+            pos = self._frame(buf, sync, readings)
+
+        del buf[:pos]
+        if len(buf) > MAX_LINE:
+            self.rejected += 1
+            buf.clear()
+        return readings
+
+    def flush(self):
+        """Interpreta o que sobrou como uma última linha (fim de uma gravação)."""
+        readings = []
+        if self._buffer:
+            self._lines(self._buffer, readings)
+            self._buffer.clear()
+        return readings
+
+    def _lines(self, text, readings):
+        # Um só decode para todas as linhas completas da leitura
+        for data in text.decode('utf-8', errors='replace').split('\n'):
+            data = data.strip()
+            if not data:
+                continue
+            parsed = extract_data_from_serial(data)
+            if parsed:
+                readings.append(parsed)
+            else:
+                self.rejected += 1
+                logger.debug(f"Linha não reconhecida: {data}")
+
+    def _frame(self, buf, start, readings):
+        """Interpreta o quadro em `start`; devolve a posição seguinte."""
+        _, temperatura, limite, alerta, alertas, checksum = FRAME.unpack_from(buf, start)
+        if sum(buf[start + 2:start + FRAME.size - 1]) & 0xff != checksum:
+            # Não era um quadro: procura o próximo a partir do byte seguinte
+            self.rejected += 1
+            return start + 1
+        readings.append({'temperatura': temperatura / 100, 'limite': limite / 100,
+                         'status_alerta': alert_status(alerta), 'alertas': alertas})
+        return start + FRAME.size
@@ -0,0 +1,111 @@
+"""
+Envio das leituras aos navegadores em lotes, a uma taxa fixa, com controle de
+fluxo por cliente.
+
+As leituras entram por push(), chamada na thread da serial, que nunca espera
+por um navegador. A cada 1/rate segundos, as novas saem em um só evento com a
+lista delas, com um número de lote. O navegador confirma cada lote (evento
+'confirmar_lote' com o número, que chega em ack()) antes de receber o
+próximo. Enquanto um navegador lento não confirma, as leituras dele se
+acumulam em uma fila limitada (as mais antigas são descartadas) e seguem
+todas juntas no lote seguinte. Uma confirmação que não chega em
+`ack_timeout_s` é dada como perdida.
+
+Os clientes em dia recebem o mesmo lote em um só emit para todos, codificado
+uma vez; só os atrasados recebem lotes próprios.
+"""
+import time
+import logging
+import threading
+from collections import deque
+
+
+class _Client:
+    def __init__(self, backlog_size):
+        self.backlog = deque(maxlen=backlog_size)  # Leituras ainda não enviadas
+        self.in_flight = None                      # Número do lote sem confirmação
+        self.sent_at = 0.0
+        self.dropped = 0
+
+
+class CoalescingEmitter:
+    """Junta as leituras e envia `event` a cada cliente no máximo `rate_hz` vezes por segundo"""
+
+    def __init__(self, socketio, event, rate_hz=20, backlog_size=200, ack_timeout_s=5):
+        self.socketio = socketio
+        self.event = event
+        self.rate_hz = rate_hz
+        self.backlog_size = backlog_size
+        self.ack_timeout_s = ack_timeout_s
+        self._pending = []
+        self._clients = {}
+        self._batches = 0
+        self._lock = threading.Lock()
+        self._task = None
+
+    def start(self):
+        if self._task is None:
+            self._task = self.socketio.start_background_task(self._run)
+
+    def push(self, reading):
+        with self._lock:
+            self._pending.append(reading)
+
+    def add_client(self, sid):
+        with self._lock:
+            self._clients[sid] = _Client(self.backlog_size)
+
+    def remove_client(self, sid):
+        with self._lock:
+            self._clients.pop(sid, None)
+
+    def ack(self, sid, batch_id):
+        with self._lock:
+            client = self._clients.get(sid)
+            # Uma confirmação atrasada de um lote já dado como perdido não libera o atual
+            if client and client.in_flight == batch_id:
+                client.in_flight = None
+
+    def _run(self):
+        while True:
+            self.socketio.sleep(1 / self.rate_hz)
+            try:
+                self.flush()
+            except Exception:
+                logging.exception("Erro ao enviar leituras")
+
+    def flush(self):
+        """Envia as leituras acumuladas aos clientes que já confirmaram o lote anterior."""
+        now = time.monotonic()
+        shared = []   # Clientes em dia: recebem exatamente `batch`
+        ready = []    # Atrasados: cada um com as suas leituras
+        with self._lock:
+            batch, self._pending = self._pending, []
+            self._batches += 1
+            shared_id = self._batches
+            for sid, client in self._clients.items():
+                up_to_date = not client.backlog and len(batch) <= self.backlog_size
+                if batch:
+                    overflow = len(client.backlog) + len(batch) - self.backlog_size
+                    if overflow > 0:
+                        client.dropped += overflow
+                        logging.debug(f"Cliente {sid} lento: {client.dropped} leituras descartadas")
+                    client.backlog.extend(batch)
+                if client.in_flight is not None and now - client.sent_at > self.ack_timeout_s:
+                    client.in_flight = None  # Confirmação perdida
+                if client.in_flight is None and client.backlog:
+                    client.sent_at = now
+                    if up_to_date:
+                        client.in_flight = shared_id
+                        shared.append(sid)
+                    else:
+                        self._batches += 1
+                        client.in_flight = self._batches
+                        ready.append((sid, self._batches, list(client.backlog)))
+                    client.backlog.clear()
+
+        # Fora do lock: push() não espera pelos envios
+        if shared:
+            self.socketio.emit(self.event, (shared_id, batch), to=shared)
+        for sid, batch_id, items in ready:
+            self.socketio.emit(self.event, (batch_id, items), to=sid)
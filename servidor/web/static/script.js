@@ -8,7 +8,8 @@ const socket = io({
 // Variáveis para rastreamento de tempo e sessão
 const sessionStartTime = new Date();
 let sessionInterval;
-let allTemperatures = [];
+// Estatísticas das últimas 1000 temperaturas (ver window-stats.js)
+const temperatureStats = new WindowStats(1000);
 
 // Feedback de conexão
 socket.on('connect', function() {
@@ -160,11 +161,11 @@ const statsChart = new Chart(ctxStats, {
     }
 });
 
-// Atualiza o gráfico de temperatura em tempo real
-function atualizarGraficoTemperatura(temperatura, limite) {
-    const agora = new Date().toLocaleTimeString();
+// Acrescenta uma leitura ao gráfico de temperatura (o desenho fica para o fim do lote)
+function adicionarPontoTemperatura(temperatura, limite, t) {
+    const hora = new Date(t * 1000).toLocaleTimeString();
     
-    tempChart.data.labels.push(agora);
+    tempChart.data.labels.push(hora);
     tempChart.data.datasets[0].data.push(temperatura);
     
     // Adiciona o limite apenas se disponível
@@ -211,8 +212,6 @@ function atualizarGraficoTemperatura(temperatura, limite) {
             tempChart.data.datasets[2].data.shift();
         }
     }
-    
-    tempChart.update();
 }
 
 // Atualiza o medidor de temperatura personalizado
@@ -242,20 +241,16 @@ function atualizarMedidor(temperatura, limite) {
     }
 }
 
-// Atualiza o gráfico de estatísticas
-function atualizarGraficoEstatisticas(temperatura) {
-    // Adiciona à lista de temperaturas
-    allTemperatures.push(temperatura);
-    
-    // Limita o histórico para não consumir muita memória
-    if (allTemperatures.length > 1000) {
-        allTemperatures = allTemperatures.slice(-1000);
+// Atualiza o gráfico de estatísticas com as temperaturas do lote
+function atualizarGraficoEstatisticas(temperaturas) {
+    // Cada valor atualiza as estatísticas da janela em tempo constante
+    for (const temperatura of temperaturas) {
+        temperatureStats.push(temperatura);
     }
     
-    // Calcula estatísticas
-    const min = Math.min(...allTemperatures);
-    const max = Math.max(...allTemperatures);
-    const avg = allTemperatures.reduce((sum, val) => sum + val, 0) / allTemperatures.length;
+    const min = temperatureStats.min;
+    const max = temperatureStats.max;
+    const avg = temperatureStats.mean;
     
     // Atualiza os elementos de texto
     minTempElem.textContent = min.toFixed(1) + '°C';
@@ -292,8 +287,32 @@ function updateSessionDuration() {
     sessionDurationElem.textContent = formatDuration(duration);
 }
 
-// Evento para receber novos dados do servidor via WebSocket
-socket.on('novo_dado', function(data) {
+// Leituras novas do servidor via WebSocket, em lotes. O servidor só envia o
+// próximo lote depois da confirmação deste; um navegador lento recebe lotes
+// maiores em vez de atrasar os outros.
+socket.on('novos_dados', function(lote, leituras) {
+    leituras.forEach(function(data) {
+        const limite = data.limite !== undefined ? data.limite : 40;
+        adicionarPontoTemperatura(data.temperatura, limite, data.t);
+    });
+    tempChart.update();
+    atualizarGraficoEstatisticas(leituras.map(data => data.temperatura));
+    
+    // Valores e medidor mostram a leitura mais recente; o alerta aparece se
+    // qualquer leitura do lote estava em alerta, mesmo que a última não esteja
+    const ultima = leituras[leituras.length - 1];
+    const emAlerta = leituras.find(data => alertaAtivo(data.status_alerta));
+    mostrarLeitura(ultima, emAlerta ? emAlerta.status_alerta : ultima.status_alerta);
+    
+    socket.emit('confirmar_lote', lote);
+});
+
+function alertaAtivo(statusAlerta) {
+    return statusAlerta !== undefined && statusAlerta.toLowerCase() === 'ativo';
+}
+
+// Atualiza os valores e o medidor com uma leitura, e o alerta com o status do lote
+function mostrarLeitura(data, statusAlerta) {
     const temperatura = data.temperatura;
     tempAtualElem.textContent = temperatura.toFixed(2);
     
@@ -314,11 +333,11 @@ socket.on('novo_dado', function(data) {
     const emZonaSegura = temperatura <= (limite - 2);
     
     // Atualizar status do alerta se disponível
-    if (data.status_alerta !== undefined) {
-        statusAlertaElem.textContent = data.status_alerta;
+    if (statusAlerta !== undefined) {
+        statusAlertaElem.textContent = statusAlerta;
         
         // Adicionar classe visual baseada no status
-        if (data.status_alerta.toLowerCase() === 'ativo') {
+        if (alertaAtivo(statusAlerta)) {
             statusAlertaElem.className = 'alerta-ativo';
             // Alertar visualmente
             document.body.className = 'alerta';
@@ -334,11 +353,8 @@ socket.on('novo_dado', function(data) {
         }
     }
     
-    // Atualiza todos os gráficos
-    atualizarGraficoTemperatura(temperatura, limite);
     atualizarMedidor(temperatura, limite);
-    atualizarGraficoEstatisticas(temperatura);
-});
+}
 
 // Inicialização
 document.addEventListener('DOMContentLoaded', function() {
@@ -0,0 +1,102 @@
+// Mínimo, máximo e média das últimas `capacity` temperaturas, atualizados a
+// cada valor novo em tempo constante (amortizado), sem percorrer a janela.
+// Os valores ficam em um buffer circular tipado. A soma é mantida somando o
+// valor que entra e subtraindo o que sai, e refeita do zero uma vez por volta
+// do buffer para não acumular erro de arredondamento. Mínimo e máximo vêm de
+// duas filas monotônicas com os números de sequência dos candidatos: a do
+// mínimo é crescente nos valores, a do máximo decrescente, e a frente de cada
+// uma é a resposta.
+class MonotonicQueue {
+    constructor(capacity, before) {
+        this.seqs = new Float64Array(capacity);  // Números de sequência (inteiros até 2^53)
+        this.capacity = capacity;
+        this.before = before;  // before(a, b): `a` tira `b` do fim da fila
+        this.head = 0;
+        this.length = 0;
+    }
+
+    front() {
+        return this.seqs[this.head];
+    }
+
+    back() {
+        return this.seqs[(this.head + this.length - 1) % this.capacity];
+    }
+
+    push(seq, value, values) {
+        // Quem está no fim e perde para o valor novo nunca mais será a resposta
+        while (this.length > 0 && this.before(value, values[this.back() % values.length])) {
+            this.length--;
+        }
+        this.seqs[(this.head + this.length) % this.capacity] = seq;
+        this.length++;
+    }
+
+    evict(oldestSeq) {
+        while (this.length > 0 && this.front() < oldestSeq) {
+            this.head = (this.head + 1) % this.capacity;
+            this.length--;
+        }
+    }
+
+    clear() {
+        this.head = 0;
+        this.length = 0;
+    }
+}
+
+class WindowStats {
+    constructor(capacity) {
+        this.capacity = capacity;
+        this.values = new Float64Array(capacity);
+        this.minQueue = new MonotonicQueue(capacity, (a, b) => a <= b);
+        this.maxQueue = new MonotonicQueue(capacity, (a, b) => a >= b);
+        this.clear();
+    }
+
+    push(value) {
+        const seq = this.total;
+        const slot = seq % this.capacity;
+
+        // Sai o valor mais antigo, se a janela estiver cheia
+        if (this.count === this.capacity) {
+            this.sum -= this.values[slot];
+        } else {
+            this.count++;
+        }
+        const oldestSeq = seq - this.count + 1;
+        this.minQueue.evict(oldestSeq);
+        this.maxQueue.evict(oldestSeq);
+
+        this.values[slot] = value;
+        this.sum += value;
+        this.total++;
+        this.minQueue.push(seq, value, this.values);
+        this.maxQueue.push(seq, value, this.values);
+
+        if (slot === this.capacity - 1) {
+            this.sum = this.values.reduce((sum, v) => sum + v, 0);
+        }
+    }
+
+    get min() {
+        return this.count ? this.values[this.minQueue.front() % this.capacity] : NaN;
+    }
+
+    get max() {
+        return this.count ? this.values[this.maxQueue.front() % this.capacity] : NaN;
+    }
+
+    get mean() {
+        return this.count ? this.sum / this.count : NaN;
+    }
+
+    clear() {
+        this.values.fill(0);
+        this.minQueue.clear();
+        this.maxQueue.clear();
+        this.count = 0;
+        this.total = 0;  // Valores já recebidos (o próximo número de sequência)
+        this.sum = 0;
+    }
+}
@@ -1,5 +1,5 @@
 #include <stdio.h>        // Biblioteca padrão de entrada e saída
-#include "hardware/adc.h" // Biblioteca para manipulação do ADC no RP2040
+#include "adc_stream.h"   // Serviço de aquisição contínua do ADC (round-robin + DMA)
 #include "hardware/pwm.h" // Biblioteca para controle de PWM no RP2040
 #include "pico/stdlib.h"  // Biblioteca padrão do Raspberry Pi Pico
 
@@ -10,6 +10,13 @@ const int ADC_CHANNEL_0 = 0; // Canal ADC para o eixo X do joystick
 const int ADC_CHANNEL_1 = 1; // Canal ADC para o eixo Y do joystick
 const int SW = 22;           // Pino de leitura do botão do joystick
 
+// Aquisição contínua dos eixos: 1 kHz no round-robin, média de 10 leituras (50 Hz por eixo).
+// Com ADC_STREAM_BLOCK=8 (CMakeLists.txt) as leituras chegam a cada 8 ms, não a cada 128 ms.
+const float JOY_CLOCK_DIV = 47999.f;
+const uint JOY_DECIMATION = 10;
+#define JOY_RING_SIZE 16
+uint16_t vrx_ring[JOY_RING_SIZE], vry_ring[JOY_RING_SIZE]; // Buffers circulares de cada eixo
+
 const int LED_B = 13;                    // Pino para controle do LED azul via PWM
 const int LED_R = 11;                    // Pino para controle do LED vermelho via PWM
 const float DIVIDER_PWM = 16.0;          // Divisor fracional do clock para o PWM
@@ -20,10 +27,11 @@ uint slice_led_b, slice_led_r;           // Variáveis para armazenar os slices
 // Função para configurar o joystick (pinos de leitura e ADC)
 void setup_joystick()
 {
-  // Inicializa o ADC e os pinos de entrada analógica
-  adc_init();         // Inicializa o módulo ADC
-  adc_gpio_init(VRX); // Configura o pino VRX (eixo X) para entrada ADC
-  adc_gpio_init(VRY); // Configura o pino VRY (eixo Y) para entrada ADC
+  // Inicializa o ADC e os pinos de entrada analógica (eixos X e Y no mesmo fluxo de DMA)
+  adc_stream_init(JOY_CLOCK_DIV);                                                  // Inicializa o ADC e o DMA
+  adc_stream_add_channel(ADC_CHANNEL_0, vrx_ring, JOY_RING_SIZE, JOY_DECIMATION); // Eixo X (GPIO 26)
+  adc_stream_add_channel(ADC_CHANNEL_1, vry_ring, JOY_RING_SIZE, JOY_DECIMATION); // Eixo Y (GPIO 27)
+  adc_stream_start();                                                              // Inicia a aquisição contínua
 
   // Inicializa o pino do botão do joystick
   gpio_init(SW);             // Inicializa o pino do botão
@@ -54,15 +62,9 @@ void setup()
 // Função para ler os valores dos eixos do joystick (X e Y)
 void joystick_read_axis(uint16_t *vrx_value, uint16_t *vry_value)
 {
-  // Leitura do valor do eixo X do joystick
-  adc_select_input(ADC_CHANNEL_0); // Seleciona o canal ADC para o eixo X
-  sleep_us(2);                     // Pequeno delay para estabilidade
-  *vrx_value = adc_read();         // Lê o valor do eixo X (0-4095)
-
-  // Leitura do valor do eixo Y do joystick
-  adc_select_input(ADC_CHANNEL_1); // Seleciona o canal ADC para o eixo Y
-  sleep_us(2);                     // Pequeno delay para estabilidade
-  *vry_value = adc_read();         // Lê o valor do eixo Y (0-4095)
+  // Última leitura de cada eixo já separada pelo serviço de aquisição (0-4095)
+  *vrx_value = adc_stream_latest(ADC_CHANNEL_0); // Eixo X
+  *vry_value = adc_stream_latest(ADC_CHANNEL_1); // Eixo Y
 }
 
 // Função principal